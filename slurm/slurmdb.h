@@ -609,6 +609,8 @@ struct slurmdb_assoc_usage {
 				 * (DON'T PACK for state file) */
 	uint32_t level_shares;  /* number of shares on this level of
 				 * the tree (DON'T PACK for state file) */
+	bool no_tres_limits;	/* none of the grp/max TRES limits is set
+				 * (DON'T PACK) */
 
 	slurmdb_assoc_rec_t *parent_assoc_ptr; /* ptr to direct
 						* parent assoc
@@ -712,6 +714,10 @@ struct slurmdb_cluster_rec {
 						* cluster */
 	uint16_t rpc_version; /* rpc version this cluster is running */
 	List send_rpc;        /* For convenience only. DOESN'T GET PACKED */
+	uint16_t send_rpc_defer; /* current send_rpc backoff in seconds.
+				  * For convenience only. DOESN'T GET PACKED */
+	time_t send_rpc_retry; /* hold send_rpc until this time. For
+				* convenience only. DOESN'T GET PACKED */
 	char  	*tres_str;    /* comma separated list of TRES */
 };
 
@@ -884,6 +890,8 @@ typedef struct {
 				 * running jobs */
 	double norm_priority;/* normalized priority (DON'T PACK for
 			      * state file) */
+	bool no_tres_limits;	/* none of the grp/max/min TRES limits is set
+				 * (DON'T PACK) */
 	uint32_t tres_cnt; /* size of the tres arrays,
 			    * (DON'T PACK for state file) */
 	long double usage_raw;	/* measure of resource usage */
@@ -76,6 +76,8 @@ static pthread_mutex_t assoc_lock_init = PTHREAD_MUTEX_INITIALIZER;
 static assoc_init_args_t init_setup;
 static slurmdb_assoc_rec_t **assoc_hash_id = NULL;
 static slurmdb_assoc_rec_t **assoc_hash = NULL;
+static slurmdb_user_rec_t **user_hash_uid = NULL;
+static uint32_t user_hash_uid_size = 0;	/* power of 2, 0 if not built */
 static int *assoc_mgr_tres_old_pos = NULL;
 
 static bool _running_cache(void)
@@ -682,6 +684,70 @@ static int _list_find_uid(void *x, void *key)
 	return 0;
 }
 
+static uint32_t _user_hash_uid_inx(uint32_t uid)
+{
+	return (uid ^ (uid >> 16)) & (user_hash_uid_size - 1);
+}
+
+/*
+ * Rebuild the uid hash of assoc_mgr_user_list. Call whenever a user is
+ * added or removed, a uid changes or the list is replaced.
+ * locks should be put in place before calling this function USER_WRITE
+ */
+static void _rebuild_user_hash(void)
+{
+	slurmdb_user_rec_t *user;
+	ListIterator itr;
+	uint32_t inx, size = 64;
+
+	xfree(user_hash_uid);
+	user_hash_uid_size = 0;
+
+	if (!assoc_mgr_user_list)
+		return;
+
+	while (size < (list_count(assoc_mgr_user_list) * 2))
+		size <<= 1;
+	user_hash_uid = xcalloc(size, sizeof(slurmdb_user_rec_t *));
+	user_hash_uid_size = size;
+
+	itr = list_iterator_create(assoc_mgr_user_list);
+	while ((user = list_next(itr))) {
+		if (user->uid == NO_VAL)
+			continue;
+		inx = _user_hash_uid_inx(user->uid);
+		while (user_hash_uid[inx] &&
+		       (user_hash_uid[inx]->uid != user->uid))
+			inx = (inx + 1) & (size - 1);
+		/* Keep the first match of a list search */
+		if (!user_hash_uid[inx])
+			user_hash_uid[inx] = user;
+	}
+	list_iterator_destroy(itr);
+}
+
+/* locks should be put in place before calling this function USER_READ */
+static slurmdb_user_rec_t *_find_user_uid(uint32_t uid)
+{
+	slurmdb_user_rec_t *user;
+	uint32_t inx;
+
+	if (!user_hash_uid_size)
+		return list_find_first(assoc_mgr_user_list, _list_find_uid,
+				       &uid);
+	if (uid == NO_VAL)
+		return NULL;
+
+	inx = _user_hash_uid_inx(uid);
+	while ((user = user_hash_uid[inx])) {
+		if (user->uid == uid)
+			return user;
+		inx = (inx + 1) & (user_hash_uid_size - 1);
+	}
+
+	return NULL;
+}
+
 /* locks should be put in place before calling this function USER_WRITE */
 static void _set_user_default_acct(slurmdb_assoc_rec_t *assoc)
 {
@@ -691,8 +757,7 @@ static void _set_user_default_acct(slurmdb_assoc_rec_t *assoc)
 
 	/* set up the default if this is it */
 	if ((assoc->is_def == 1) && (assoc->uid != NO_VAL)) {
-		slurmdb_user_rec_t *user = list_find_first(
-			assoc_mgr_user_list, _list_find_uid, &assoc->uid);
+		slurmdb_user_rec_t *user = _find_user_uid(assoc->uid);
 
 		if (!user)
 			return;
@@ -718,8 +783,7 @@ static void _set_user_default_wckey(slurmdb_wckey_rec_t *wckey)
 
 	/* set up the default if this is it */
 	if ((wckey->is_def == 1) && (wckey->uid != NO_VAL)) {
-		slurmdb_user_rec_t *user = list_find_first(
-			assoc_mgr_user_list, _list_find_uid, &wckey->uid);
+		slurmdb_user_rec_t *user = _find_user_uid(wckey->uid);
 
 		if (!user)
 			return;
@@ -953,6 +1017,58 @@ static void _calculate_assoc_norm_priorities(bool new_max)
 	list_iterator_destroy(itr);
 }
 
+static bool _tres_limits_unset(uint64_t *tres_limits)
+{
+	if (!tres_limits)
+		return true;
+
+	for (int i = 0; i < g_tres_count; i++) {
+		if (tres_limits[i] != INFINITE64)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Flag associations without any TRES limit so acct_policy can skip them
+ * when testing a job's TRES request. Call whenever a *_ctld array changes.
+ */
+static void _set_assoc_no_tres_limits(slurmdb_assoc_rec_t *assoc)
+{
+	if (!assoc->usage)
+		return;
+
+	assoc->usage->no_tres_limits =
+		_tres_limits_unset(assoc->grp_tres_ctld) &&
+		_tres_limits_unset(assoc->grp_tres_mins_ctld) &&
+		_tres_limits_unset(assoc->grp_tres_run_mins_ctld) &&
+		_tres_limits_unset(assoc->max_tres_ctld) &&
+		_tres_limits_unset(assoc->max_tres_pn_ctld) &&
+		_tres_limits_unset(assoc->max_tres_mins_ctld) &&
+		_tres_limits_unset(assoc->max_tres_run_mins_ctld);
+}
+
+/* Same as _set_assoc_no_tres_limits() for a QOS */
+static void _set_qos_no_tres_limits(slurmdb_qos_rec_t *qos)
+{
+	if (!qos->usage)
+		return;
+
+	qos->usage->no_tres_limits =
+		_tres_limits_unset(qos->grp_tres_ctld) &&
+		_tres_limits_unset(qos->grp_tres_mins_ctld) &&
+		_tres_limits_unset(qos->grp_tres_run_mins_ctld) &&
+		_tres_limits_unset(qos->max_tres_pa_ctld) &&
+		_tres_limits_unset(qos->max_tres_pj_ctld) &&
+		_tres_limits_unset(qos->max_tres_pn_ctld) &&
+		_tres_limits_unset(qos->max_tres_pu_ctld) &&
+		_tres_limits_unset(qos->max_tres_mins_pj_ctld) &&
+		_tres_limits_unset(qos->max_tres_run_mins_pa_ctld) &&
+		_tres_limits_unset(qos->max_tres_run_mins_pu_ctld) &&
+		_tres_limits_unset(qos->min_tres_pj_ctld);
+}
+
 static void _set_qos_norm_priority(slurmdb_qos_rec_t *qos)
 {
 	if (!qos || !g_qos_max_priority)
@@ -1666,6 +1782,8 @@ static int _get_assoc_mgr_user_list(void *db_conn, int enforce)
 
 	assoc_mgr_lock(&locks);
 	FREE_NULL_LIST(assoc_mgr_user_list);
+	xfree(user_hash_uid);
+	user_hash_uid_size = 0;
 	assoc_mgr_user_list = acct_storage_g_get_users(db_conn, uid, &user_q);
 
 	if (!assoc_mgr_user_list) {
@@ -1679,6 +1797,7 @@ static int _get_assoc_mgr_user_list(void *db_conn, int enforce)
 	}
 
 	_post_user_list(assoc_mgr_user_list);
+	_rebuild_user_hash();
 
 	assoc_mgr_unlock(&locks);
 	return SLURM_SUCCESS;
@@ -1935,6 +2054,7 @@ static int _refresh_assoc_mgr_user_list(void *db_conn, int enforce)
 	FREE_NULL_LIST(assoc_mgr_user_list);
 
 	assoc_mgr_user_list = current_users;
+	_rebuild_user_hash();
 
 	assoc_mgr_unlock(&locks);
 
@@ -2101,6 +2221,8 @@ extern int assoc_mgr_fini(bool save_state)
 
 	xfree(assoc_hash_id);
 	xfree(assoc_hash);
+	xfree(user_hash_uid);
+	user_hash_uid_size = 0;
 
 	assoc_mgr_unlock(&locks);
 
@@ -2632,16 +2754,16 @@ extern int assoc_mgr_fill_in_user(void *db_conn, slurmdb_user_rec_t *user,
 		return SLURM_SUCCESS;
 	}
 
-	itr = list_iterator_create(assoc_mgr_user_list);
-	while ((found_user = list_next(itr))) {
-		if (user->uid != NO_VAL) {
-			if (user->uid == found_user->uid)
+	if (user->uid != NO_VAL)
+		found_user = _find_user_uid(user->uid);
+	else if (user->name) {
+		itr = list_iterator_create(assoc_mgr_user_list);
+		while ((found_user = list_next(itr))) {
+			if (!xstrcasecmp(user->name, found_user->name))
 				break;
-		} else if (user->name
-			   && !xstrcasecmp(user->name, found_user->name))
-			break;
+		}
+		list_iterator_destroy(itr);
 	}
-	list_iterator_destroy(itr);
 
 	if (!found_user) {
 		if (!locked)
@@ -3018,7 +3140,7 @@ extern slurmdb_admin_level_t assoc_mgr_get_admin_level(void *db_conn,
 		return SLURMDB_ADMIN_NOTSET;
 	}
 
-	found_user = list_find_first(assoc_mgr_user_list, _list_find_uid, &uid);
+	found_user = _find_user_uid(uid);
 
 	if (found_user)
 		level = found_user->admin_level;
@@ -3050,8 +3172,7 @@ extern bool assoc_mgr_is_user_acct_coord(void *db_conn,
 		return false;
 	}
 
-	found_user = list_find_first(assoc_mgr_user_list, _list_find_uid,
-				     &uid);
+	found_user = _find_user_uid(uid);
 
 	if (!found_user || !found_user->coord_accts) {
 		assoc_mgr_unlock(&locks);
@@ -3939,6 +4060,8 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 
 			/* info("now rec has def of %d", rec->def_qos_id); */
 
+			_set_assoc_no_tres_limits(rec);
+
 			if (update_jobs && init_setup.update_assoc_notify) {
 				/* since there are some deadlock
 				   issues while inside our lock here
@@ -4430,6 +4553,7 @@ extern int assoc_mgr_update_users(slurmdb_update_object_t *update, bool locked)
 		slurmdb_destroy_user_rec(object);
 	}
 	list_iterator_destroy(itr);
+	_rebuild_user_hash();
 	if (!locked)
 		assoc_mgr_unlock(&locks);
 
@@ -4752,6 +4876,8 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 			if (!fuzzy_equal(object->limit_factor, NO_VAL))
 				rec->limit_factor = object->limit_factor;
 
+			_set_qos_no_tres_limits(rec);
+
 			if (update_jobs && init_setup.update_qos_notify) {
 				/* since there are some deadlock
 				   issues while inside our lock here
@@ -6024,6 +6150,7 @@ extern int load_assoc_mgr_state(bool only_tres)
 			FREE_NULL_LIST(assoc_mgr_user_list);
 			assoc_mgr_user_list = msg->my_list;
 			_post_user_list(assoc_mgr_user_list);
+			_rebuild_user_hash();
 			debug("Recovered %u users",
 			      list_count(assoc_mgr_user_list));
 			msg->my_list = NULL;
@@ -6228,6 +6355,7 @@ extern int assoc_mgr_set_missing_uids()
 			}
 		}
 		list_iterator_destroy(itr);
+		_rebuild_user_hash();
 	}
 	assoc_mgr_unlock(&locks);
 
@@ -6420,6 +6548,7 @@ extern void assoc_mgr_set_assoc_tres_cnt(slurmdb_assoc_rec_t *assoc)
 				     assoc->max_tres_mins_pj, INFINITE64, 1);
 	assoc_mgr_set_tres_cnt_array(&assoc->max_tres_run_mins_ctld,
 				     assoc->max_tres_run_mins, INFINITE64, 1);
+	_set_assoc_no_tres_limits(assoc);
 }
 
 /* tres read lock needs to be locked before this is called. */
@@ -6453,6 +6582,7 @@ extern void assoc_mgr_set_qos_tres_cnt(slurmdb_qos_rec_t *qos)
 				     qos->max_tres_run_mins_pu, INFINITE64, 1);
 	assoc_mgr_set_tres_cnt_array(&qos->min_tres_pj_ctld,
 				     qos->min_tres_pj, INFINITE64, 1);
+	_set_qos_no_tres_limits(qos);
 }
 
 extern char *assoc_mgr_make_tres_str_from_array(
@@ -58,6 +58,7 @@ typedef struct {
 	int	(*step_get_pids)	(pid_t **pids, int *npids);
 	int	(*step_suspend)		(void);
 	int	(*step_resume)		(void);
+	int	(*step_kill)		(int timeout_ms);
 	int	(*step_destroy)		(cgroup_ctl_type_t sub);
 	bool	(*has_pid)		(pid_t pid);
 	cgroup_limits_t *(*constrain_get) (cgroup_ctl_type_t sub,
@@ -92,6 +93,7 @@ static const char *syms[] = {
 	"cgroup_p_step_get_pids",
 	"cgroup_p_step_suspend",
 	"cgroup_p_step_resume",
+	"cgroup_p_step_kill",
 	"cgroup_p_step_destroy",
 	"cgroup_p_has_pid",
 	"cgroup_p_constrain_get",
@@ -919,6 +921,14 @@ extern int cgroup_g_step_resume(void)
 	return (*(ops.step_resume))();
 }
 
+extern int cgroup_g_step_kill(int timeout_ms)
+{
+	if (cgroup_g_init() < 0)
+		return SLURM_ERROR;
+
+	return (*(ops.step_kill))(timeout_ms);
+}
+
 extern int cgroup_g_step_destroy(cgroup_ctl_type_t sub)
 {
 	if (cgroup_g_init() < 0)
@@ -300,6 +300,16 @@ extern int cgroup_g_step_suspend(void);
  */
 extern int cgroup_g_step_resume(void);
 
+/*
+ * Kill all the user processes of the step at once and wait up to timeout_ms
+ * milliseconds for them to be gone.
+ *
+ * RET SLURM_SUCCESS if the user processes are gone (or were signaled when
+ * timeout_ms is 0), ESLURM_NOT_SUPPORTED if the plugin or kernel has no way
+ * to do this, SLURM_ERROR otherwise.
+ */
+extern int cgroup_g_step_kill(int timeout_ms);
+
 /*
  * If the caller (typically from a plugin) is the only one using this step
  * object, rmdir the controller's step directories and destroy the associated
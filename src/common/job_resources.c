@@ -414,6 +414,7 @@ extern void free_job_resources(job_resources_t **job_resrcs_pptr)
 		xfree(job_resrcs_ptr->nodes);
 		xfree(job_resrcs_ptr->sock_core_rep_count);
 		xfree(job_resrcs_ptr->sockets_per_node);
+		xfree(job_resrcs_ptr->steps_used);
 		xfree(job_resrcs_ptr->tasks_per_node);
 		xfree(job_resrcs_ptr);
 		*job_resrcs_pptr = NULL;
@@ -532,13 +533,292 @@ extern void log_job_resources(void *void_job_ptr)
 	info("====================");
 }
 
+/* Core bitmap encodings used by pack_job_resources() */
+#define JOB_RES_CORE_MAP_FULL    0	/* Whole bitmap is packed */
+#define JOB_RES_CORE_MAP_UNIFORM 1	/* One node's cores, same on all nodes */
+
+/*
+ * Pack a per node array as (value, repetition count) runs, the same way
+ * cpu_array_value and cpu_array_reps compress the CPU counts. Allocations
+ * using the same amount of a resource on every node pack to a single run.
+ */
+static void _pack_rle16_array(uint16_t *array, uint32_t cnt, buf_t *buffer)
+{
+	uint32_t i, reps, runs = 0;
+
+	if (!array)
+		cnt = 0;
+	for (i = 0; i < cnt; i++) {
+		if (!i || (array[i] != array[i - 1]))
+			runs++;
+	}
+	pack32(cnt, buffer);
+	pack32(runs, buffer);
+	for (i = 0; i < cnt; i += reps) {
+		for (reps = 1; ((i + reps) < cnt) &&
+			       (array[i + reps] == array[i]); reps++)
+			;
+		pack16(array[i], buffer);
+		pack32(reps, buffer);
+	}
+}
+
+static int _unpack_rle16_array(uint16_t **array, uint32_t expect_cnt,
+			       buf_t *buffer)
+{
+	uint32_t cnt, runs, reps, i, j, k = 0;
+	uint16_t val;
+
+	*array = NULL;
+	safe_unpack32(&cnt, buffer);
+	safe_unpack32(&runs, buffer);
+	if (!cnt)
+		return SLURM_SUCCESS;
+	if ((cnt != expect_cnt) || (runs > cnt))
+		goto unpack_error;
+
+	*array = xcalloc(cnt, sizeof(uint16_t));
+	for (i = 0; i < runs; i++) {
+		safe_unpack16(&val, buffer);
+		safe_unpack32(&reps, buffer);
+		if (reps > (cnt - k))
+			goto unpack_error;
+		for (j = 0; j < reps; j++)
+			(*array)[k++] = val;
+	}
+	if (k != cnt)
+		goto unpack_error;
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(*array);
+	return SLURM_ERROR;
+}
+
+static void _pack_rle64_array(uint64_t *array, uint32_t cnt, buf_t *buffer)
+{
+	uint32_t i, reps, runs = 0;
+
+	if (!array)
+		cnt = 0;
+	for (i = 0; i < cnt; i++) {
+		if (!i || (array[i] != array[i - 1]))
+			runs++;
+	}
+	pack32(cnt, buffer);
+	pack32(runs, buffer);
+	for (i = 0; i < cnt; i += reps) {
+		for (reps = 1; ((i + reps) < cnt) &&
+			       (array[i + reps] == array[i]); reps++)
+			;
+		pack64(array[i], buffer);
+		pack32(reps, buffer);
+	}
+}
+
+static int _unpack_rle64_array(uint64_t **array, uint32_t expect_cnt,
+			       buf_t *buffer)
+{
+	uint32_t cnt, runs, reps, i, j, k = 0;
+	uint64_t val;
+
+	*array = NULL;
+	safe_unpack32(&cnt, buffer);
+	safe_unpack32(&runs, buffer);
+	if (!cnt)
+		return SLURM_SUCCESS;
+	if ((cnt != expect_cnt) || (runs > cnt))
+		goto unpack_error;
+
+	*array = xcalloc(cnt, sizeof(uint64_t));
+	for (i = 0; i < runs; i++) {
+		safe_unpack64(&val, buffer);
+		safe_unpack32(&reps, buffer);
+		if (reps > (cnt - k))
+			goto unpack_error;
+		for (j = 0; j < reps; j++)
+			(*array)[k++] = val;
+	}
+	if (k != cnt)
+		goto unpack_error;
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(*array);
+	return SLURM_ERROR;
+}
+
+/*
+ * Return the bitmap of one node's cores if every node of the allocation has
+ * the same socket/core layout and the same cores set in core_map, else NULL.
+ */
+static bitstr_t *_uniform_node_core_map(job_resources_t *job_resrcs_ptr,
+					bitstr_t *core_map, uint32_t sock_recs)
+{
+	uint32_t node_cores, n, c, offset;
+	bitstr_t *node_map;
+
+	if (!core_map || (sock_recs != 1) || (job_resrcs_ptr->nhosts < 2))
+		return NULL;
+
+	node_cores = job_resrcs_ptr->sockets_per_node[0] *
+		     job_resrcs_ptr->cores_per_socket[0];
+	if (!node_cores ||
+	    (bit_size(core_map) != (node_cores * job_resrcs_ptr->nhosts)))
+		return NULL;
+
+	node_map = bit_alloc(node_cores);
+	for (c = 0; c < node_cores; c++) {
+		if (bit_test(core_map, c))
+			bit_set(node_map, c);
+	}
+	for (n = 1, offset = node_cores; n < job_resrcs_ptr->nhosts;
+	     n++, offset += node_cores) {
+		for (c = 0; c < node_cores; c++) {
+			if (bit_test(core_map, offset + c) !=
+			    bit_test(node_map, c)) {
+				FREE_NULL_BITMAP(node_map);
+				return NULL;
+			}
+		}
+	}
+
+	return node_map;
+}
+
+/*
+ * Pack a core bitmap. When every node of the allocation uses the same cores,
+ * as is typical for whole node and other regular allocations, only one
+ * node's cores are packed.
+ */
+static void _pack_core_bitmap(job_resources_t *job_resrcs_ptr,
+			      bitstr_t *core_map, uint32_t sock_recs,
+			      buf_t *buffer)
+{
+	bitstr_t *node_map;
+
+	if ((node_map = _uniform_node_core_map(job_resrcs_ptr, core_map,
+					       sock_recs))) {
+		pack8(JOB_RES_CORE_MAP_UNIFORM, buffer);
+		pack_bit_str_hex(node_map, buffer);
+		FREE_NULL_BITMAP(node_map);
+	} else {
+		pack8(JOB_RES_CORE_MAP_FULL, buffer);
+		pack_bit_str_hex(core_map, buffer);
+	}
+}
+
+static int _unpack_core_bitmap(job_resources_t *job_resrcs,
+			       bitstr_t **core_map, buf_t *buffer)
+{
+	bitstr_t *node_map = NULL;
+	uint32_t node_cores, n, offset;
+	uint8_t encoding;
+	int c;
+
+	safe_unpack8(&encoding, buffer);
+	if (encoding == JOB_RES_CORE_MAP_FULL) {
+		unpack_bit_str_hex(core_map, buffer);
+		return SLURM_SUCCESS;
+	} else if (encoding != JOB_RES_CORE_MAP_UNIFORM)
+		goto unpack_error;
+
+	unpack_bit_str_hex(&node_map, buffer);
+	if (!node_map || !job_resrcs->sockets_per_node ||
+	    !job_resrcs->cores_per_socket)
+		goto unpack_error;
+	node_cores = job_resrcs->sockets_per_node[0] *
+		     job_resrcs->cores_per_socket[0];
+	if ((bit_size(node_map) != node_cores) || !job_resrcs->nhosts ||
+	    (job_resrcs->nhosts > (INT32_MAX / node_cores)))
+		goto unpack_error;
+
+	*core_map = bit_alloc(node_cores * job_resrcs->nhosts);
+	for (c = 0; (c = bit_ffs_from_bit(node_map, c)) >= 0; c++) {
+		for (n = 0, offset = c; n < job_resrcs->nhosts;
+		     n++, offset += node_cores)
+			bit_set(*core_map, offset);
+	}
+	FREE_NULL_BITMAP(node_map);
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	FREE_NULL_BITMAP(node_map);
+	return SLURM_ERROR;
+}
+
 extern void pack_job_resources(job_resources_t *job_resrcs_ptr, buf_t *buffer,
 			       uint16_t protocol_version)
 {
 	int i;
 	uint32_t sock_recs = 0;
 
-	if (protocol_version >= SLURM_22_05_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_23_02_PROTOCOL_VERSION) {
+		if (job_resrcs_ptr == NULL) {
+			uint32_t empty = NO_VAL;
+			pack32(empty, buffer);
+			return;
+		}
+
+		pack32(job_resrcs_ptr->nhosts, buffer);
+		pack32(job_resrcs_ptr->ncpus, buffer);
+		pack32(job_resrcs_ptr->node_req, buffer);
+		packstr(job_resrcs_ptr->nodes, buffer);
+		pack8(job_resrcs_ptr->whole_node, buffer);
+		pack16(job_resrcs_ptr->threads_per_core, buffer);
+		pack16(job_resrcs_ptr->cr_type, buffer);
+
+		if (job_resrcs_ptr->cpu_array_reps)
+			pack32_array(job_resrcs_ptr->cpu_array_reps,
+				     job_resrcs_ptr->cpu_array_cnt, buffer);
+		else
+			pack32_array(job_resrcs_ptr->cpu_array_reps, 0, buffer);
+
+		if (job_resrcs_ptr->cpu_array_value)
+			pack16_array(job_resrcs_ptr->cpu_array_value,
+				     job_resrcs_ptr->cpu_array_cnt, buffer);
+		else
+			pack16_array(job_resrcs_ptr->cpu_array_value,
+				     0, buffer);
+
+		/* Per node arrays are run-length encoded */
+		_pack_rle16_array(job_resrcs_ptr->cpus,
+				  job_resrcs_ptr->nhosts, buffer);
+		_pack_rle16_array(job_resrcs_ptr->cpus_used,
+				  job_resrcs_ptr->nhosts, buffer);
+		_pack_rle64_array(job_resrcs_ptr->memory_allocated,
+				  job_resrcs_ptr->nhosts, buffer);
+		_pack_rle64_array(job_resrcs_ptr->memory_used,
+				  job_resrcs_ptr->nhosts, buffer);
+
+		xassert(job_resrcs_ptr->cores_per_socket);
+		xassert(job_resrcs_ptr->sock_core_rep_count);
+		xassert(job_resrcs_ptr->sockets_per_node);
+
+		for (i=0; i < job_resrcs_ptr->nhosts; i++) {
+			sock_recs += job_resrcs_ptr->
+				     sock_core_rep_count[i];
+			if (sock_recs >= job_resrcs_ptr->nhosts)
+				break;
+		}
+		i++;
+		pack16_array(job_resrcs_ptr->sockets_per_node,
+			     (uint32_t) i, buffer);
+		pack16_array(job_resrcs_ptr->cores_per_socket,
+			     (uint32_t) i, buffer);
+		pack32_array(job_resrcs_ptr->sock_core_rep_count,
+			     (uint32_t) i, buffer);
+
+		xassert(job_resrcs_ptr->core_bitmap);
+		xassert(job_resrcs_ptr->core_bitmap_used);
+		_pack_core_bitmap(job_resrcs_ptr, job_resrcs_ptr->core_bitmap,
+				  i, buffer);
+		_pack_core_bitmap(job_resrcs_ptr,
+				  job_resrcs_ptr->core_bitmap_used, i, buffer);
+	} else if (protocol_version >= SLURM_22_05_PROTOCOL_VERSION) {
 		if (job_resrcs_ptr == NULL) {
 			uint32_t empty = NO_VAL;
 			pack32(empty, buffer);
@@ -704,7 +984,70 @@ extern int unpack_job_resources(job_resources_t **job_resrcs_pptr,
 	job_resources_t *job_resrcs;
 
 	xassert(job_resrcs_pptr);
-	if (protocol_version >= SLURM_22_05_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_23_02_PROTOCOL_VERSION) {
+		safe_unpack32(&empty, buffer);
+		if (empty == NO_VAL) {
+			*job_resrcs_pptr = NULL;
+			return SLURM_SUCCESS;
+		}
+
+		job_resrcs = xmalloc(sizeof(struct job_resources));
+		job_resrcs->nhosts = empty;
+		safe_unpack32(&job_resrcs->ncpus, buffer);
+		safe_unpack32(&job_resrcs->node_req, buffer);
+		safe_unpackstr_xmalloc(&job_resrcs->nodes, &tmp32, buffer);
+		safe_unpack8(&job_resrcs->whole_node, buffer);
+		safe_unpack16(&job_resrcs->threads_per_core, buffer);
+		safe_unpack16(&job_resrcs->cr_type, buffer);
+
+		safe_unpack32_array(&job_resrcs->cpu_array_reps,
+				    &tmp32, buffer);
+		if (tmp32 == 0)
+			xfree(job_resrcs->cpu_array_reps);
+		job_resrcs->cpu_array_cnt = tmp32;
+
+		safe_unpack16_array(&job_resrcs->cpu_array_value,
+				    &tmp32, buffer);
+		if (tmp32 == 0)
+			xfree(job_resrcs->cpu_array_value);
+
+		if (tmp32 != job_resrcs->cpu_array_cnt)
+			goto unpack_error;
+
+		if (_unpack_rle16_array(&job_resrcs->cpus,
+					job_resrcs->nhosts, buffer) ||
+		    (!job_resrcs->cpus && job_resrcs->nhosts))
+			goto unpack_error;
+		if (_unpack_rle16_array(&job_resrcs->cpus_used,
+					job_resrcs->nhosts, buffer))
+			goto unpack_error;
+		if (_unpack_rle64_array(&job_resrcs->memory_allocated,
+					job_resrcs->nhosts, buffer))
+			goto unpack_error;
+		if (_unpack_rle64_array(&job_resrcs->memory_used,
+					job_resrcs->nhosts, buffer))
+			goto unpack_error;
+
+		safe_unpack16_array(&job_resrcs->sockets_per_node,
+				    &tmp32, buffer);
+		if (tmp32 == 0)
+			xfree(job_resrcs->sockets_per_node);
+		safe_unpack16_array(&job_resrcs->cores_per_socket,
+				    &tmp32, buffer);
+		if (tmp32 == 0)
+			xfree(job_resrcs->cores_per_socket);
+		safe_unpack32_array(&job_resrcs->sock_core_rep_count,
+				    &tmp32, buffer);
+		if (tmp32 == 0)
+			xfree(job_resrcs->sock_core_rep_count);
+
+		if (_unpack_core_bitmap(job_resrcs, &job_resrcs->core_bitmap,
+					buffer))
+			goto unpack_error;
+		if (_unpack_core_bitmap(job_resrcs,
+					&job_resrcs->core_bitmap_used, buffer))
+			goto unpack_error;
+	} else if (protocol_version >= SLURM_22_05_PROTOCOL_VERSION) {
 		safe_unpack32(&empty, buffer);
 		if (empty == NO_VAL) {
 			*job_resrcs_pptr = NULL;
@@ -1273,6 +1616,7 @@ extern int job_resources_or(job_resources_t *job_resrcs1_ptr,
 		job_resrcs_new->sock_core_rep_count;
 	xfree(job_resrcs1_ptr->sockets_per_node);
 	job_resrcs1_ptr->sockets_per_node = job_resrcs_new->sockets_per_node;
+	xfree(job_resrcs1_ptr->steps_used);	/* Rebuilt on demand */
 	xfree(job_resrcs_new);
 
 	return rc;
@@ -1448,6 +1792,7 @@ extern int extract_job_resources_node(job_resources_t *job, uint32_t node_id)
 		job->memory_allocated[i] = job->memory_allocated[i+1];
 		job->memory_used[i] = job->memory_used[i+1];
 	}
+	xfree(job->steps_used);	/* Rebuilt on demand */
 
 	xfree(job->nodes);
 	job->nodes = bitmap2node_name(job->node_bitmap);
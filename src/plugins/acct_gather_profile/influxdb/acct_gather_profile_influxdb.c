@@ -59,6 +59,7 @@
 
 #include "src/common/slurm_xlator.h"
 #include "src/common/fd.h"
+#include "src/common/list.h"
 #include "src/common/macros.h"
 #include "src/common/slurm_acct_gather_profile.h"
 #include "src/common/slurm_protocol_api.h"
@@ -69,6 +70,8 @@
 #include "src/slurmd/common/proctrack.h"
 
 #define DEFAULT_INFLUXDB_TIMEOUT 10
+#define MAX_QUEUED_BATCHES 64	/* Batches held while influxdb is unreachable */
+#define MAX_SEND_RETRY_DELAY 60	/* seconds */
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -134,6 +137,15 @@ static stepd_step_rec_t *g_job = NULL;
 static char *datastr = NULL;
 static int datastrlen = 0;
 
+/* Batches waiting for _send_thread, protected by send_mutex */
+static pthread_mutex_t send_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t send_cond = PTHREAD_COND_INITIALIZER;
+static List send_list = NULL;
+static pthread_t send_tid = 0;
+static bool send_shutdown = false;
+static time_t send_deadline = 0;	/* give up on unsent data after shutdown */
+static bool send_thread_failed = false;
+
 static table_t *tables = NULL;
 static size_t tables_max_len = 0;
 static size_t tables_cur_len = 0;
@@ -193,8 +205,12 @@ static size_t _write_callback(void *contents, size_t size, size_t nmemb,
 	return realsize;
 }
 
-/* Try to send data to influxdb */
-static int _send_data(const char *data)
+/*
+ * POST one batch of line protocol data to influxdb.
+ * timeout IN - maximum time in seconds for the request
+ * retry OUT - set if the failure is transient and the batch should be resent
+ */
+static int _post_data(const char *batch, uint32_t timeout, bool *retry)
 {
 	CURL *curl_handle = NULL;
 	CURLcode res;
@@ -203,35 +219,15 @@ static int _send_data(const char *data)
 	long response_code;
 	static int error_cnt = 0;
 	char *url = NULL;
-	size_t length;
 
 	debug3("%s %s called", plugin_type, __func__);
 
-	/*
-	 * Every compute node which is sampling data will try to establish a
-	 * different connection to the influxdb server. In order to reduce the
-	 * number of connections, every time a new sampled data comes in, it
-	 * is saved in the 'datastr' buffer. Once this buffer is full, then we
-	 * try to open the connection and send this buffer, instead of opening
-	 * one per sample.
-	 */
-	if (data && ((datastrlen + strlen(data)) <= BUF_SIZE)) {
-		xstrcat(datastr, data);
-		length = strlen(data);
-		datastrlen += length;
-		log_flag(PROFILE, "%s %s: %zu bytes of data added to buffer. New buffer size: %d",
-			 plugin_type, __func__, length, datastrlen);
-		return rc;
-	}
+	*retry = true;
 
 	DEF_TIMERS;
 	START_TIMER;
 
-	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
-		error("%s %s: curl_global_init: %m", plugin_type, __func__);
-		rc = SLURM_ERROR;
-		goto cleanup_global_init;
-	} else if ((curl_handle = curl_easy_init()) == NULL) {
+	if ((curl_handle = curl_easy_init()) == NULL) {
 		error("%s %s: curl_easy_init: %m", plugin_type, __func__);
 		rc = SLURM_ERROR;
 		goto cleanup_easy_init;
@@ -247,19 +243,21 @@ static int _send_data(const char *data)
 	if (influxdb_conf.password)
 		curl_easy_setopt(curl_handle, CURLOPT_PASSWORD,
 				 influxdb_conf.password);
-	curl_easy_setopt(curl_handle, CURLOPT_POST, 1);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, datastr);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, strlen(datastr));
+	curl_easy_setopt(curl_handle, CURLOPT_POST, 1L);
+	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, batch);
+	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE,
+			 (long) strlen(batch));
 	if (influxdb_conf.username)
 		curl_easy_setopt(curl_handle, CURLOPT_USERNAME,
 				 influxdb_conf.username);
 	curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, _write_callback);
 	curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *) &chunk);
-	curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, influxdb_conf.timeout);
+	curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, (long) timeout);
+	curl_easy_setopt(curl_handle, CURLOPT_NOSIGNAL, 1L);
 
 	if ((res = curl_easy_perform(curl_handle)) != CURLE_OK) {
 		if ((error_cnt++ % 100) == 0)
-			error("%s %s: curl_easy_perform failed to send data (discarded). Reason: %s",
+			error("%s %s: curl_easy_perform failed to send data (will retry). Reason: %s",
 			      plugin_type, __func__, curl_easy_strerror(res));
 		rc = SLURM_ERROR;
 		goto cleanup;
@@ -285,6 +283,9 @@ static int _send_data(const char *data)
 			error_cnt = 0;
 	} else {
 		rc = SLURM_ERROR;
+		/* Resending a request influxdb could not parse won't help */
+		if ((response_code >= 400) && (response_code < 500))
+			*retry = false;
 		debug2("%s %s: data write failed, response code: %ld",
 		       plugin_type, __func__, response_code);
 		if (slurm_conf.debug_flags & DEBUG_FLAG_PROFILE) {
@@ -301,22 +302,160 @@ cleanup:
 	xfree(url);
 cleanup_easy_init:
 	curl_easy_cleanup(curl_handle);
-cleanup_global_init:
-	curl_global_cleanup();
 
 	END_TIMER;
 	log_flag(PROFILE, "%s %s: took %s to send data",
 		 plugin_type, __func__, TIME_STR);
 
+	return rc;
+}
+
+/*
+ * Sender thread. Posts queued batches in order so that sampling never waits
+ * on the influxdb server. A batch which fails for a transient reason stays at
+ * the head of the queue and is retried with exponential backoff. Once shutdown
+ * is requested, what is left is sent for at most ProfileInfluxDBTimeout.
+ */
+static void *_send_thread(void *arg)
+{
+	char *batch;
+	bool retry;
+	int delay = 0;
+	uint32_t timeout;
+	time_t now;
+	struct timespec ts = {0, 0};
+
+	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
+		error("%s %s: curl_global_init: %m", plugin_type, __func__);
+		slurm_mutex_lock(&send_mutex);
+		list_flush(send_list);
+		send_thread_failed = true;
+		slurm_mutex_unlock(&send_mutex);
+		return NULL;
+	}
+
+	slurm_mutex_lock(&send_mutex);
+	while (1) {
+		if (!list_count(send_list)) {
+			if (send_shutdown)
+				break;
+			slurm_cond_wait(&send_cond, &send_mutex);
+			continue;
+		}
+		timeout = influxdb_conf.timeout;
+		if (send_shutdown) {
+			now = time(NULL);
+			if (now >= send_deadline) {
+				error("%s %s: discarding %d batches of unsent data",
+				      plugin_type, __func__,
+				      list_count(send_list));
+				list_flush(send_list);
+				break;
+			}
+			if (!timeout || (timeout > (send_deadline - now)))
+				timeout = send_deadline - now;
+		}
+		batch = list_pop(send_list);
+		slurm_mutex_unlock(&send_mutex);
+
+		if ((_post_data(batch, timeout, &retry) == SLURM_SUCCESS) ||
+		    !retry) {
+			xfree(batch);
+			delay = 0;
+			slurm_mutex_lock(&send_mutex);
+			continue;
+		}
+
+		slurm_mutex_lock(&send_mutex);
+		if (send_shutdown) {
+			error("%s %s: discarding %d batches of unsent data",
+			      plugin_type, __func__, list_count(send_list) + 1);
+			xfree(batch);
+			list_flush(send_list);
+			break;
+		}
+		list_push(send_list, batch);
+		delay = delay ? MIN(delay * 2, MAX_SEND_RETRY_DELAY) : 1;
+		ts.tv_sec = time(NULL) + delay;
+		while (!send_shutdown && (time(NULL) < ts.tv_sec))
+			slurm_cond_timedwait(&send_cond, &send_mutex, &ts);
+	}
+	slurm_mutex_unlock(&send_mutex);
+
+	curl_global_cleanup();
+
+	return NULL;
+}
+
+/*
+ * Hand a full batch to the sender thread.
+ * send_mutex must be locked on entry.
+ */
+static void _queue_batch(char *batch)
+{
+	if (send_thread_failed) {
+		xfree(batch);
+		return;
+	}
+
+	if (!send_list) {
+		send_list = list_create(xfree_ptr);
+		slurm_thread_create(&send_tid, _send_thread, NULL);
+	}
+
+	if (list_count(send_list) >= MAX_QUEUED_BATCHES) {
+		static int drop_cnt = 0;
+		if ((drop_cnt++ % 100) == 0)
+			error("%s %s: %d batches waiting to be sent, discarding the oldest",
+			      plugin_type, __func__, list_count(send_list));
+		list_flush_max(send_list, 1);
+	}
+	list_append(send_list, batch);
+	slurm_cond_signal(&send_cond);
+}
+
+/* Buffer data for influxdb, queueing it to be sent once the buffer is full */
+static int _send_data(const char *data)
+{
+	size_t length;
+
+	debug3("%s %s called", plugin_type, __func__);
+
+	slurm_mutex_lock(&send_mutex);
+
+	/*
+	 * Every compute node which is sampling data will try to establish a
+	 * different connection to the influxdb server. In order to reduce the
+	 * number of connections, every time a new sampled data comes in, it
+	 * is saved in the 'datastr' buffer. Once this buffer is full, then it
+	 * is queued to be sent, instead of opening one connection per sample.
+	 */
+	if (data && ((datastrlen + strlen(data)) <= BUF_SIZE)) {
+		xstrcat(datastr, data);
+		length = strlen(data);
+		datastrlen += length;
+		log_flag(PROFILE, "%s %s: %zu bytes of data added to buffer. New buffer size: %d",
+			 plugin_type, __func__, length, datastrlen);
+		slurm_mutex_unlock(&send_mutex);
+		return SLURM_SUCCESS;
+	}
+
+	if (datastrlen)
+		_queue_batch(datastr);
+	else
+		xfree(datastr);
+
 	if (data) {
 		datastr = xstrdup(data);
 		datastrlen = strlen(data);
 	} else {
-		datastr[0] = '\0';
+		datastr = xmalloc(BUF_SIZE);
 		datastrlen = 0;
 	}
 
-	return rc;
+	slurm_mutex_unlock(&send_mutex);
+
+	return SLURM_SUCCESS;
 }
 
 /*
@@ -338,6 +477,21 @@ extern int fini(void)
 {
 	debug3("%s %s called", plugin_type, __func__);
 
+	if (running_in_slurmstepd()) {
+		/* Queue anything left and wait for it to be sent */
+		_send_data(NULL);
+		slurm_mutex_lock(&send_mutex);
+		send_shutdown = true;
+		send_deadline = time(NULL) + (influxdb_conf.timeout ?
+					      influxdb_conf.timeout :
+					      DEFAULT_INFLUXDB_TIMEOUT);
+		slurm_cond_signal(&send_cond);
+		slurm_mutex_unlock(&send_mutex);
+		if (send_tid)
+			pthread_join(send_tid, NULL);
+		FREE_NULL_LIST(send_list);
+	}
+
 	_free_tables();
 	xfree(datastr);
 	xfree(influxdb_conf.host);
@@ -36,6 +36,7 @@
 
 #include <jwt.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
@@ -55,6 +56,9 @@
 
 #include "auth_jwt.h"
 
+/* Number of verified tokens remembered, see _token_cache_find() */
+#define TOKEN_CACHE_SIZE 256
+
 /*
  * These variables are required by the generic plugin interface.  If they
  * are not found in the plugin, the plugin loader will ignore it.
@@ -128,6 +132,77 @@ __thread char *thread_username = NULL;
 static const char *jwt_key_field = "jwt_key=";
 static const char *jwks_key_field = "jwks=";
 
+/*
+ * Tokens which passed signature verification, so that a client reusing the
+ * same token (e.g. slurmrestd) does not pay for jwt_decode() on every RPC.
+ * Direct-mapped by a hash of the token; a colliding token replaces the entry.
+ * Keys are only loaded in init(), so the cache never outlives them.
+ */
+typedef struct {
+	char *token;
+	char *username;
+	time_t exp;
+} token_cache_t;
+
+static token_cache_t token_cache[TOKEN_CACHE_SIZE];
+static pthread_mutex_t token_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t _token_cache_inx(const char *token)
+{
+	uint32_t hash = 2166136261U;
+
+	for (const char *c = token; *c; c++)
+		hash = (hash ^ (uint8_t) *c) * 16777619U;
+
+	return hash % TOKEN_CACHE_SIZE;
+}
+
+/* Return username from a previously verified and unexpired token, or NULL */
+static char *_token_cache_find(const char *token)
+{
+	token_cache_t *entry;
+	char *username = NULL;
+
+	slurm_mutex_lock(&token_cache_lock);
+	entry = &token_cache[_token_cache_inx(token)];
+	if (entry->token && !xstrcmp(entry->token, token)) {
+		if (entry->exp < time(NULL)) {
+			xfree(entry->token);
+			xfree(entry->username);
+		} else {
+			username = xstrdup(entry->username);
+		}
+	}
+	slurm_mutex_unlock(&token_cache_lock);
+
+	return username;
+}
+
+static void _token_cache_add(const char *token, const char *username,
+			     time_t exp)
+{
+	token_cache_t *entry;
+
+	slurm_mutex_lock(&token_cache_lock);
+	entry = &token_cache[_token_cache_inx(token)];
+	xfree(entry->token);
+	xfree(entry->username);
+	entry->token = xstrdup(token);
+	entry->username = xstrdup(username);
+	entry->exp = exp;
+	slurm_mutex_unlock(&token_cache_lock);
+}
+
+static void _token_cache_flush(void)
+{
+	slurm_mutex_lock(&token_cache_lock);
+	for (int i = 0; i < TOKEN_CACHE_SIZE; i++) {
+		xfree(token_cache[i].token);
+		xfree(token_cache[i].username);
+	}
+	slurm_mutex_unlock(&token_cache_lock);
+}
+
 static data_for_each_cmd_t _build_jwks_keys(data_t *d, void *arg)
 {
 	char *alg, *kid, *n, *e, *key, *x5c, *kty;
@@ -279,6 +354,7 @@ extern int init(void)
 
 extern int fini(void)
 {
+	_token_cache_flush();
 	xfree(claim_field);
 	FREE_NULL_DATA(jwks);
 	FREE_NULL_BUFFER(key);
@@ -355,6 +431,7 @@ int auth_p_verify(auth_token_t *cred, char *auth_info)
 	const char *alg;
 	jwt_t *unverified_jwt = NULL, *jwt = NULL;
 	char *username = NULL;
+	time_t exp;
 
 	if (!cred)
 		return SLURM_ERROR;
@@ -373,6 +450,10 @@ int auth_p_verify(auth_token_t *cred, char *auth_info)
 		goto fail;
 	}
 
+	/* This exact token was verified before and has not expired yet */
+	if ((username = _token_cache_find(cred->token)))
+		goto have_username;
+
 	if ((rc = jwt_decode(&unverified_jwt, cred->token, NULL, 0))) {
 		error("%s: initial jwt_decode failure: %s",
 		      __func__, slurm_strerror(rc));
@@ -435,7 +516,7 @@ int auth_p_verify(auth_token_t *cred, char *auth_info)
 	 * check the expiration, and sort out the appropriate username
 	 */
 
-	if (jwt_get_grant_int(jwt, "exp") < time(NULL)) {
+	if ((exp = jwt_get_grant_int(jwt, "exp")) < time(NULL)) {
 		error("%s: token expired", __func__);
 		goto fail;
 	}
@@ -453,6 +534,11 @@ int auth_p_verify(auth_token_t *cred, char *auth_info)
 		goto fail;
 	}
 
+	jwt_free(jwt);
+	jwt = NULL;
+	_token_cache_add(cred->token, username, exp);
+
+have_username:
 	if (!cred->username)
 		cred->username = username;
 	else if (!xstrcmp(cred->username, username)) {
@@ -61,8 +61,14 @@
 #include "src/common/xsignal.h"
 #include "src/common/xstring.h"
 
+/*
+ * munged failing with EMUNGE_SOCKET is usually just momentarily busy, so
+ * retry after RETRY_USEC_MIN and back off to RETRY_USEC between attempts,
+ * giving up after waiting for RETRY_COUNT * RETRY_USEC in total.
+ */
 #define RETRY_COUNT		20
 #define RETRY_USEC		100000
+#define RETRY_USEC_MIN		1000
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -122,6 +128,7 @@ extern int auth_p_destroy(auth_credential_t *cred);
 
 static int _decode_cred(auth_credential_t *c, char *socket, bool test);
 static void _print_cred(munge_ctx_t ctx);
+static bool _retry_wait(int *retry_usec, int *waited_usec);
 
 /*
  *  Munge plugin initialization
@@ -166,7 +173,7 @@ int init(void)
  */
 auth_credential_t *auth_p_create(char *opts, uid_t r_uid, void *data, int dlen)
 {
-	int rc, retry = RETRY_COUNT, auth_ttl;
+	int rc, auth_ttl, retry_usec = RETRY_USEC_MIN, waited_usec = 0;
 	auth_credential_t *cred = NULL;
 	munge_err_t err = EMUNGE_SUCCESS;
 	munge_ctx_t ctx = munge_ctx_create();
@@ -219,10 +226,10 @@ auth_credential_t *auth_p_create(char *opts, uid_t r_uid, void *data, int dlen)
 again:
 	err = munge_encode(&cred->m_str, ctx, data, dlen);
 	if (err != EMUNGE_SUCCESS) {
-		if ((err == EMUNGE_SOCKET) && retry--) {
+		if ((err == EMUNGE_SOCKET) &&
+		    _retry_wait(&retry_usec, &waited_usec)) {
 			debug("Munge encode failed: %s (retrying ...)",
 			      munge_ctx_strerror(ctx));
-			usleep(RETRY_USEC);	/* Likely munged too busy */
 			goto again;
 		}
 		if (err == EMUNGE_SOCKET)
@@ -491,7 +498,7 @@ unpack_error:
  */
 static int _decode_cred(auth_credential_t *c, char *socket, bool test)
 {
-	int retry = RETRY_COUNT;
+	int retry_usec = RETRY_USEC_MIN, waited_usec = 0;
 	munge_err_t err;
 	munge_ctx_t ctx;
 
@@ -519,10 +526,10 @@ again:
 	if (err != EMUNGE_SUCCESS) {
 		if (test)
 			goto done;
-		if ((err == EMUNGE_SOCKET) && retry--) {
+		if ((err == EMUNGE_SOCKET) &&
+		    _retry_wait(&retry_usec, &waited_usec)) {
 			debug("Munge decode failed: %s (retrying ...)",
 			      munge_ctx_strerror(ctx));
-			usleep(RETRY_USEC);	/* Likely munged too busy */
 			goto again;
 		}
 		if (err == EMUNGE_SOCKET)
@@ -572,6 +579,22 @@ done:
 	return err ? SLURM_ERROR : SLURM_SUCCESS;
 }
 
+/*
+ * Sleep before retrying a munged request, doubling the delay each time.
+ * Return false without sleeping once the retry time is used up.
+ */
+static bool _retry_wait(int *retry_usec, int *waited_usec)
+{
+	if (*waited_usec >= (RETRY_COUNT * RETRY_USEC))
+		return false;
+
+	usleep(*retry_usec);	/* Likely munged too busy */
+	*waited_usec += *retry_usec;
+	*retry_usec = MIN(*retry_usec * 2, RETRY_USEC);
+
+	return true;
+}
+
 /*
  *  Print credential information.
  */
@@ -2917,6 +2917,9 @@ static int _identify_bb_candidate(void *x, void *arg)
 	} else if (bb_job->state >= BB_STATE_POST_RUN) {
 		/* Requeued job still staging out */
 		return SLURM_SUCCESS;
+	} else if (bb_job->state >= BB_STATE_STAGING_IN) {
+		/* Buffer already allocated, nothing to queue */
+		return SLURM_SUCCESS;
 	}
 	job_rec = xmalloc(sizeof(bb_job_queue_rec_t));
 	job_rec->job_ptr = job_ptr;
@@ -3500,6 +3503,18 @@ extern int bb_p_job_try_stage_in(List job_queue)
 		return SLURM_SUCCESS;
 	}
 
+	/*
+	 * No stage-in slot is free, so no job could be allocated a buffer.
+	 * Avoid walking and sorting the whole job queue while holding
+	 * bb_mutex, which also blocks the stage-in threads from finishing.
+	 */
+	if (stage_in_cnt >= MAX_BURST_BUFFERS_PER_STAGE) {
+		log_flag(BURST_BUF, "%d stage-in operations in progress, skipping",
+			 stage_in_cnt);
+		slurm_mutex_unlock(&bb_state.bb_mutex);
+		return SLURM_SUCCESS;
+	}
+
 	/* Identify candidates to be allocated burst buffers */
 	job_candidates = list_create(xfree_ptr);
 	list_for_each(job_queue, _identify_bb_candidate, job_candidates);
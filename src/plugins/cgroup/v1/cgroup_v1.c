@@ -791,6 +791,12 @@ extern int cgroup_p_step_resume(void)
 				       "freezer.state", "THAWED");
 }
 
+extern int cgroup_p_step_kill(int timeout_ms)
+{
+	/* There is no cgroup.kill interface in cgroup v1 */
+	return ESLURM_NOT_SUPPORTED;
+}
+
 static int _step_destroy_internal(cgroup_ctl_type_t sub, bool root_locked)
 {
 	int rc = SLURM_SUCCESS;
@@ -36,13 +36,16 @@
 
 #define _GNU_SOURCE
 
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/inotify.h>
 #include <poll.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "slurm/slurm.h"
@@ -79,6 +82,9 @@ static bpf_program_t p[CG_LEVEL_CNT];
 static char *stepd_scope_path = NULL;
 static uint32_t task_special_id = NO_VAL;
 static char *invoc_id;
+/* cpuset values written to this job's cgroup by this slurmstepd */
+static char *job_cpuset_cpus = NULL;
+static char *job_cpuset_mems = NULL;
 static char *ctl_names[] = {
 	[CG_TRACK] = "freezer",
 	[CG_CPUS] = "cpuset",
@@ -203,18 +209,58 @@ static void _set_int_cg_ns()
 static int _enable_subtree_control(char *path, bitstr_t *ctl_bitmap)
 {
 	int i, rc = SLURM_SUCCESS;
-	char *content = NULL, *file_path = NULL;
+	char *content = NULL, *file_path = NULL, *buf = NULL, *ptr, *save_ptr;
+	size_t sz;
+	bitstr_t *enabled = bit_alloc(CG_CTL_CNT);
 
 	xassert(ctl_bitmap);
 
 	xstrfmtcat(file_path, "%s/cgroup.subtree_control", path);
+
+	/*
+	 * Skip the controllers which are already enabled here, e.g. in the job
+	 * directory when another step of the same job created it.
+	 */
+	if ((common_file_read_content(file_path, &buf, &sz) ==
+	     SLURM_SUCCESS) && buf) {
+		ptr = strtok_r(buf, " \n", &save_ptr);
+		while (ptr) {
+			for (i = 0; i < CG_CTL_CNT; i++) {
+				if (!xstrcmp(ctl_names[i], ptr))
+					bit_set(enabled, i);
+			}
+			ptr = strtok_r(NULL, " \n", &save_ptr);
+		}
+	}
+	xfree(buf);
+
+	/* Enable the rest with a single write */
 	for (i = 0; i < CG_CTL_CNT; i++) {
-		if (!bit_test(ctl_bitmap, i))
+		if (!bit_test(ctl_bitmap, i) || bit_test(enabled, i))
+			continue;
+		xstrfmtcat(content, "%s+%s", content ? " " : "",
+			   ctl_names[i]);
+	}
+	if (!content) {
+		log_flag(CGROUP, "Controllers already enabled in %s",
+			 file_path);
+		goto end;
+	}
+	if (common_file_write_content(file_path, content, strlen(content)) ==
+	    SLURM_SUCCESS) {
+		log_flag(CGROUP, "Enabled %s in %s", content, file_path);
+		goto end;
+	}
+	xfree(content);
+
+	/* Fall back to one controller at a time to find the failing one */
+	for (i = 0; i < CG_CTL_CNT; i++) {
+		if (!bit_test(ctl_bitmap, i) || bit_test(enabled, i))
 			continue;
 
 		xstrfmtcat(content, "+%s", ctl_names[i]);
 		rc = common_file_write_content(file_path, content,
-					       sizeof(content));
+					       strlen(content));
 		xfree(content);
 		if (rc != SLURM_SUCCESS) {
 			error("Cannot enable %s in %s",
@@ -227,7 +273,10 @@ static int _enable_subtree_control(char *path, bitstr_t *ctl_bitmap)
 			bit_set(ctl_bitmap, i);
 		}
 	}
+end:
+	xfree(content);
 	xfree(file_path);
+	FREE_NULL_BITMAP(enabled);
 	return rc;
 }
 
@@ -458,14 +507,13 @@ static int _find_pid_task(void *x, void *key)
 	return found;
 }
 
-static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
+/* Return the "populated" value of cg's cgroup.events, or -1 on error */
+static int _get_cgroup_populated(xcgroup_t *cg)
 {
-	char *cgroup_events = NULL, *events_content = NULL, *ptr;
-	int rc, fd, wd, populated = -1;
+	char *events_content = NULL, *ptr;
+	int populated = -1;
 	size_t sz;
-	struct pollfd pfd[1];
 
-	/* Check if cgroup is empty in the first place. */
 	if (common_cgroup_get_param(
 		    cg, "cgroup.events", &events_content, &sz) != SLURM_SUCCESS)
 		error("Cannot read %s/cgroup.events", cg->path);
@@ -478,11 +526,30 @@ static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
 		xfree(events_content);
 	}
 
+	return populated;
+}
+
+/*
+ * Wait up to timeout_ms for the cgroup to have no processes left in it.
+ * RET SLURM_SUCCESS if the cgroup is empty, SLURM_ERROR otherwise.
+ */
+static int _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
+{
+	char *cgroup_events = NULL;
+	char ev_buf[sizeof(struct inotify_event) + NAME_MAX + 1]
+		__attribute__ ((aligned(__alignof__(struct inotify_event))));
+	int rc, fd, wd, populated, remain_ms;
+	struct pollfd pfd[1];
+	struct timespec start, now;
+
+	/* Check if cgroup is empty in the first place. */
+	populated = _get_cgroup_populated(cg);
+
 	if (populated < 0) {
 		error("Cannot determine if %s is empty.", cg->path);
-		return;
+		return SLURM_ERROR;
 	} else if (populated == 0) //We're done
-		return;
+		return SLURM_SUCCESS;
 
 	/*
 	 * Cgroup is not empty, so wait for a while just monitoring any change
@@ -495,7 +562,8 @@ static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
 	fd = inotify_init();
 	if (fd < 0) {
 		error("Cannot initialize inotify for checking cgroup events: %m");
-		return;
+		xfree(cgroup_events);
+		return SLURM_ERROR;
 	}
 
 	/* Set the file and events we want to monitor. */
@@ -505,31 +573,46 @@ static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
 		goto end_inotify;
 	}
 
-	/* Wait for new events. */
-	pfd[0].fd = fd;
-	pfd[0].events = POLLIN;
-	rc = poll(pfd, 1, timeout_ms);
-
 	/*
-	 * We don't really care about the event details, just check now if the
-	 * cg event file contains what we're looking for.
+	 * The file may have changed before the watch was added, and it is
+	 * also modified for reasons other than the populated value changing,
+	 * so check it again after every event until the timeout expires.
 	 */
-	if (rc < 0)
-		error("Error polling for event in %s: %m", cgroup_events);
-	else if (rc == 0)
-		error("Timeout waiting for %s to become empty.", cgroup_events);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	pfd[0].fd = fd;
+	pfd[0].events = POLLIN;
+	while ((populated = _get_cgroup_populated(cg)) == 1) {
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		remain_ms = timeout_ms -
+			    ((now.tv_sec - start.tv_sec) * 1000) -
+			    ((now.tv_nsec - start.tv_nsec) / 1000000);
+		if (remain_ms <= 0) {
+			error("Timeout waiting for %s to become empty.",
+			      cgroup_events);
+			break;
+		}
 
-	/* Check if cgroup is empty again. */
-	if (common_cgroup_get_param(cg, "cgroup.events",
-				    &events_content, &sz) != SLURM_SUCCESS)
-		error("Cannot read %s/cgroup.events", cg->path);
+		/* Wait for new events. */
+		rc = poll(pfd, 1, remain_ms);
+		if ((rc < 0) && (errno == EINTR))
+			continue;
+		if (rc < 0) {
+			error("Error polling for event in %s: %m",
+			      cgroup_events);
+			break;
+		}
 
-	if (events_content) {
-		if ((ptr = xstrstr(events_content, "populated"))) {
-			if (sscanf(ptr, "populated %u", &populated) != 1)
-				error("Cannot read populated counter from cgroup.events file.");
+		/*
+		 * We don't really care about the event details, just consume
+		 * them and check if the cg event file contains what we're
+		 * looking for.
+		 */
+		if ((rc > 0) && (read(fd, ev_buf, sizeof(ev_buf)) < 0) &&
+		    (errno != EINTR) && (errno != EAGAIN)) {
+			error("Cannot read inotify events for %s: %m",
+			      cgroup_events);
+			break;
 		}
-		xfree(events_content);
 	}
 
 	if (populated < 0)
@@ -540,6 +623,8 @@ static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
 end_inotify:
 	close(fd);
 	xfree(cgroup_events);
+
+	return (populated == 0) ? SLURM_SUCCESS : SLURM_ERROR;
 }
 
 static int _init_stepd_system_scope(pid_t pid)
@@ -1001,6 +1086,8 @@ extern int fini(void)
 	free_ebpf_prog(&p[CG_LEVEL_JOB]);
 	free_ebpf_prog(&p[CG_LEVEL_STEP_USER]);
 	xfree(stepd_scope_path);
+	xfree(job_cpuset_cpus);
+	xfree(job_cpuset_mems);
 
 	debug("unloading %s", plugin_name);
 	return SLURM_SUCCESS;
@@ -1300,6 +1387,39 @@ extern int cgroup_p_step_resume()
 				       "cgroup.freeze", "0");
 }
 
+/*
+ * Kill the user processes of this step through cgroup.kill, which signals
+ * every process in the subtree atomically, and wait for them to be gone.
+ */
+extern int cgroup_p_step_kill(int timeout_ms)
+{
+	char *kill_file = NULL;
+	struct stat st;
+	int rc;
+
+	/* This plugin is unloaded. */
+	if (!int_cg[CG_LEVEL_STEP_USER].path)
+		return SLURM_SUCCESS;
+
+	/* cgroup.kill was added in kernel 5.14 */
+	xstrfmtcat(kill_file, "%s/cgroup.kill",
+		   int_cg[CG_LEVEL_STEP_USER].path);
+	rc = stat(kill_file, &st);
+	xfree(kill_file);
+	if (rc < 0)
+		return ESLURM_NOT_SUPPORTED;
+
+	if ((rc = common_cgroup_set_param(&int_cg[CG_LEVEL_STEP_USER],
+					  "cgroup.kill", "1")) !=
+	    SLURM_SUCCESS)
+		return rc;
+
+	if (!timeout_ms)
+		return SLURM_SUCCESS;
+
+	return _wait_cgroup_empty(&int_cg[CG_LEVEL_STEP_USER], timeout_ms);
+}
+
 /*
  * Destroy the step cgroup. We need to move out ourselves to the root of
  * the cgroup filesystem first.
@@ -1474,19 +1594,36 @@ extern int cgroup_p_constrain_set(cgroup_ctl_type_t ctl, cgroup_level_t level,
 		/* Not implemented. */
 		break;
 	case CG_CPUS:
+		/*
+		 * A new step cgroup has an empty cpuset, which means it uses
+		 * the job's. Skip writing the same values again at the step
+		 * level.
+		 */
 		if (limits->allow_cores &&
-		    common_cgroup_set_param(
-			    &int_cg[level],
-			    "cpuset.cpus",
-			    limits->allow_cores) != SLURM_SUCCESS) {
-			rc = SLURM_ERROR;
+		    ((level != CG_LEVEL_STEP_USER) ||
+		     xstrcmp(limits->allow_cores, job_cpuset_cpus))) {
+			if (common_cgroup_set_param(
+				    &int_cg[level],
+				    "cpuset.cpus",
+				    limits->allow_cores) != SLURM_SUCCESS) {
+				rc = SLURM_ERROR;
+			} else if (level == CG_LEVEL_JOB) {
+				xfree(job_cpuset_cpus);
+				job_cpuset_cpus = xstrdup(limits->allow_cores);
+			}
 		}
 		if (limits->allow_mems &&
-		    common_cgroup_set_param(
-			    &int_cg[level],
-			    "cpuset.mems",
-			    limits->allow_mems) != SLURM_SUCCESS) {
-			rc = SLURM_ERROR;
+		    ((level != CG_LEVEL_STEP_USER) ||
+		     xstrcmp(limits->allow_mems, job_cpuset_mems))) {
+			if (common_cgroup_set_param(
+				    &int_cg[level],
+				    "cpuset.mems",
+				    limits->allow_mems) != SLURM_SUCCESS) {
+				rc = SLURM_ERROR;
+			} else if (level == CG_LEVEL_JOB) {
+				xfree(job_cpuset_mems);
+				job_cpuset_mems = xstrdup(limits->allow_mems);
+			}
 		}
 		break;
 	case CG_MEMORY:
@@ -57,7 +57,9 @@
 #include "src/common/slurm_xlator.h"
 #include "src/common/assoc_mgr.h"
 #include "src/common/gres.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
+#include "src/common/xstring.h"
 #include "src/lua/slurm_lua.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
@@ -95,22 +97,41 @@ const char plugin_name[]       	= "Job submit lua plugin";
 const char plugin_type[]       	= "job_submit/lua";
 const uint32_t plugin_version   = SLURM_VERSION_NUMBER;
 
+#define MAX_LUA_STATES 64
+
+/*
+ * Independently loaded copy of the script. Each one is used by one thread
+ * at a time, so several submissions can run the script concurrently.
+ */
+typedef struct {
+	lua_State *L;
+	time_t load_time;	/* mtime of script loaded in this state */
+	time_t jobs_update;	/* last_job_update of slurm.jobs, Lua 5.1 */
+	time_t resv_update;	/* last_resv_update of slurm.reservations */
+	bool in_use;
+	uint32_t call_cnt;
+	uint64_t call_time;	/* total usec in job_submit/job_modify */
+	uint64_t call_time_max;	/* max usec of a single call */
+} lua_state_rec_t;
+
 static char *lua_script_path;
-static time_t lua_script_last_loaded = (time_t) 0;
-static lua_State *L = NULL;
-static char *user_msg = NULL;
-time_t last_lua_jobs_update = (time_t) 0;
-time_t last_lua_resv_update = (time_t) 0;
+static lua_state_rec_t *lua_states = NULL;
+static int lua_state_cnt = 1;
+/* State and user message of the calling thread */
+static __thread lua_state_rec_t *lua_state = NULL;
+static __thread lua_State *L = NULL;
+static __thread char *user_msg = NULL;
 static const char *req_fxns[] = {
 	"slurm_job_submit",
 	"slurm_job_modify",
 	NULL
 };
 /*
- *  Mutex for protecting multi-threaded access to this plugin.
- *   (Only 1 thread at a time should be in here)
+ *  Mutex and condition for handing out lua_states to threads.
+ *   (Only 1 thread at a time should use any given state)
  */
 static pthread_mutex_t lua_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t lua_cond = PTHREAD_COND_INITIALIZER;
 
 /* These are defined here so when we link with something other than
  * the slurmctld we will have these symbols defined.  They will get
@@ -212,14 +233,34 @@ static int _job_rec_field_index(lua_State *L)
 	return slurm_lua_job_record_field(L, job_ptr, name);
 }
 
-/* Get the list of existing slurmctld job records. */
+/* Push a table whose fields are looked up in the given job record */
+static void _push_job_table(lua_State *st, job_record_t *job_ptr)
+{
+	lua_newtable(st);
+
+	lua_newtable(st);
+	lua_pushcfunction(st, _job_rec_field_index);
+	lua_setfield(st, -2, "__index");
+	/* Store the job_ptr in the metatable, so the index
+	 * function knows which struct it's getting data for.
+	 */
+	lua_pushlightuserdata(st, job_ptr);
+	lua_setfield(st, -2, "_job_rec_ptr");
+	lua_setmetatable(st, -2);
+}
+
+#if LUA_VERSION_NUM < 502
+/*
+ * Get the list of existing slurmctld job records. Lua 5.1 and LuaJIT do not
+ * honor __pairs, so slurm.jobs is filled in for pairs(slurm.jobs) to work.
+ */
 static void _update_jobs_global(lua_State *st)
 {
 	char job_id_buf[11]; /* Big enough for a uint32_t */
 	ListIterator iter;
 	job_record_t *job_ptr;
 
-	if (last_lua_jobs_update >= last_job_update) {
+	if (lua_state->jobs_update >= last_job_update) {
 		return;
 	}
 
@@ -228,33 +269,148 @@ static void _update_jobs_global(lua_State *st)
 
 	iter = list_iterator_create(job_list);
 	while ((job_ptr = list_next(iter))) {
-		/* Create an empty table, with a metatable that looks up the
-		 * data for the individual job.
-		 */
-		lua_newtable(st);
-
-		lua_newtable(st);
-		lua_pushcfunction(st, _job_rec_field_index);
-		lua_setfield(st, -2, "__index");
-		/* Store the job_record in the metatable, so the index
-		 * function knows which job it's getting data for.
-		 */
-		lua_pushlightuserdata(st, job_ptr);
-		lua_setfield(st, -2, "_job_rec_ptr");
-		lua_setmetatable(st, -2);
+		_push_job_table(st, job_ptr);
 
 		/* Lua copies passed strings, so we can reuse the buffer. */
 		snprintf(job_id_buf, sizeof(job_id_buf),
-		         "%d", job_ptr->job_id);
+		         "%u", job_ptr->job_id);
 		lua_setfield(st, -2, job_id_buf);
 	}
-	last_lua_jobs_update = last_job_update;
+	lua_state->jobs_update = last_job_update;
 	list_iterator_destroy(iter);
 
 	lua_setfield(st, -2, "jobs");
 	lua_pop(st, 1);
 }
 
+static void _register_jobs_global(lua_State *st)
+{
+	lua_state->jobs_update = 0;
+	_update_jobs_global(st);
+}
+#else
+/*
+ * Find the job record for a slurm.jobs key. Keys are job ids formatted as
+ * decimal strings, anything else does not name a job.
+ */
+static job_record_t *_find_jobs_key(lua_State *st, int index)
+{
+	const char *key;
+	char *end_ptr = NULL;
+	unsigned long job_id;
+
+	if (lua_type(st, index) != LUA_TSTRING)
+		return NULL;
+	key = lua_tostring(st, index);
+	if ((key[0] < '1') || (key[0] > '9'))
+		return NULL;
+	job_id = strtoul(key, &end_ptr, 10);
+	if (end_ptr[0] || (job_id > UINT32_MAX))
+		return NULL;
+
+	return find_job_record(job_id);
+}
+
+/* __index metamethod of slurm.jobs */
+static int _jobs_index(lua_State *st)
+{
+	job_record_t *job_ptr = _find_jobs_key(st, 2);
+
+	if (job_ptr)
+		_push_job_table(st, job_ptr);
+	else
+		lua_pushnil(st);
+
+	return 1;
+}
+
+typedef struct {
+	uint32_t cnt;
+	uint32_t *job_ids;
+} jobs_snapshot_t;
+
+static int _add_jobs_snapshot(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+	jobs_snapshot_t *snapshot = arg;
+
+	snapshot->job_ids[++snapshot->cnt] = job_ptr->job_id;
+
+	return 0;
+}
+
+/*
+ * Iterator returned by _jobs_pairs(). Upvalue 1 holds the job ids captured
+ * when the loop started (count first), upvalue 2 the next offset to return.
+ */
+static int _jobs_next(lua_State *st)
+{
+	char job_id_buf[11]; /* Big enough for a uint32_t */
+	uint32_t *job_ids = lua_touserdata(st, lua_upvalueindex(1));
+	uint32_t inx = lua_tointeger(st, lua_upvalueindex(2));
+	job_record_t *job_ptr;
+
+	while (inx < job_ids[0]) {
+		/* Jobs purged since the loop started are skipped */
+		if (!(job_ptr = find_job_record(job_ids[++inx])))
+			continue;
+
+		lua_pushinteger(st, inx);
+		lua_replace(st, lua_upvalueindex(2));
+
+		snprintf(job_id_buf, sizeof(job_id_buf), "%u", job_ptr->job_id);
+		lua_pushstring(st, job_id_buf);
+		_push_job_table(st, job_ptr);
+		return 2;
+	}
+
+	lua_pushnil(st);
+	return 1;
+}
+
+/*
+ * __pairs metamethod of slurm.jobs. Only the job ids are copied, the
+ * records themselves are looked up as the loop reaches them.
+ */
+static int _jobs_pairs(lua_State *st)
+{
+	jobs_snapshot_t snapshot = { 0 };
+	int cnt = list_count(job_list);
+
+	snapshot.job_ids = lua_newuserdata(st, sizeof(uint32_t) * (cnt + 1));
+	list_for_each(job_list, _add_jobs_snapshot, &snapshot);
+	snapshot.job_ids[0] = snapshot.cnt;
+
+	lua_pushinteger(st, 0);
+	lua_pushcclosure(st, _jobs_next, 2);
+	lua_pushvalue(st, 1);
+	lua_pushnil(st);
+
+	return 3;
+}
+
+/*
+ * Set slurm.jobs to an empty table whose metamethods resolve job ids to
+ * records when they are used, so nothing here depends on the number of jobs.
+ * Iterating with pairs() this way requires Lua 5.2 or newer.
+ */
+static void _register_jobs_global(lua_State *st)
+{
+	lua_getglobal(st, "slurm");
+	lua_newtable(st);
+
+	lua_newtable(st);
+	lua_pushcfunction(st, _jobs_index);
+	lua_setfield(st, -2, "__index");
+	lua_pushcfunction(st, _jobs_pairs);
+	lua_setfield(st, -2, "__pairs");
+	lua_setmetatable(st, -2);
+
+	lua_setfield(st, -2, "jobs");
+	lua_pop(st, 1);
+}
+#endif
+
 static int _resv_field(const slurmctld_resv_t *resv_ptr,
                        const char *name)
 {
@@ -319,7 +475,7 @@ static void _update_resvs_global(lua_State *st)
 	ListIterator iter;
 	slurmctld_resv_t *resv_ptr;
 
-	if (last_lua_resv_update >= last_resv_update) {
+	if (lua_state->resv_update >= last_resv_update) {
 		return;
 	}
 
@@ -345,7 +501,7 @@ static void _update_resvs_global(lua_State *st)
 
 		lua_setfield(st, -2, resv_ptr->name);
 	}
-	last_lua_resv_update = last_resv_update;
+	lua_state->resv_update = last_resv_update;
 	list_iterator_destroy(iter);
 
 	lua_setfield(st, -2, "reservations");
@@ -1062,17 +1218,7 @@ static void _push_job_desc(job_desc_msg_t *job_desc)
 
 static void _push_job_rec(job_record_t *job_ptr)
 {
-	lua_newtable(L);
-
-	lua_newtable(L);
-	lua_pushcfunction(L, _job_rec_field_index);
-	lua_setfield(L, -2, "__index");
-	/* Store the job_ptr in the metatable, so the index
-	 * function knows which struct it's getting data for.
-	 */
-	lua_pushlightuserdata(L, job_ptr);
-	lua_setfield(L, -2, "_job_rec_ptr");
-	lua_setmetatable(L, -2);
+	_push_job_table(L, job_ptr);
 }
 
 /* Get fields in an existing slurmctld partition record
@@ -1286,9 +1432,8 @@ static void _register_local_output_functions(lua_State *L)
 	/* Must be always done after we register the slurm_functions */
 	lua_setglobal(L, "slurm");
 
-	last_lua_jobs_update = 0;
-	_update_jobs_global(L);
-	last_lua_resv_update = 0;
+	_register_jobs_global(L);
+	lua_state->resv_update = 0;
 	_update_resvs_global(L);
 }
 
@@ -1313,6 +1458,68 @@ static void _loadscript_extra(lua_State *st)
 	_register_lua_slurm_struct_functions(st);
 }
 
+static void _get_config(void)
+{
+	char *opt;
+
+	/*                      0123456789012345678901 */
+	if ((opt = xstrcasestr(slurm_conf.sched_params,
+			       "job_submit_lua_states=")))
+		lua_state_cnt = atoi(opt + 22);
+	if ((lua_state_cnt < 1) || (lua_state_cnt > MAX_LUA_STATES)) {
+		error("%s: Invalid job_submit_lua_states=%d, using 1",
+		      plugin_type, lua_state_cnt);
+		lua_state_cnt = 1;
+	}
+	debug("%s: job_submit_lua_states=%d", plugin_type, lua_state_cnt);
+}
+
+/*
+ * Wait for an unused Lua state, make it the calling thread's state and
+ * reload the script into it if it changed.
+ */
+static int _acquire_lua_state(void)
+{
+	int i, rc;
+
+	slurm_mutex_lock(&lua_lock);
+	while (true) {
+		for (i = 0; i < lua_state_cnt; i++) {
+			if (!lua_states[i].in_use)
+				break;
+		}
+		if (i < lua_state_cnt)
+			break;
+		slurm_cond_wait(&lua_cond, &lua_lock);
+	}
+	lua_states[i].in_use = true;
+	slurm_mutex_unlock(&lua_lock);
+
+	lua_state = &lua_states[i];
+	rc = slurm_lua_loadscript(&lua_state->L, "job_submit/lua",
+				  lua_script_path, req_fxns,
+				  &lua_state->load_time, _loadscript_extra);
+	L = lua_state->L;
+
+	return rc;
+}
+
+/* Record call statistics and hand the calling thread's state back */
+static void _release_lua_state(long delta_t)
+{
+	slurm_mutex_lock(&lua_lock);
+	lua_state->call_cnt++;
+	lua_state->call_time += delta_t;
+	if (lua_state->call_time_max < delta_t)
+		lua_state->call_time_max = delta_t;
+	lua_state->in_use = false;
+	slurm_cond_signal(&lua_cond);
+	slurm_mutex_unlock(&lua_lock);
+
+	lua_state = NULL;
+	L = NULL;
+}
+
 /*
  *  NOTE: The init callback should never be called multiple times,
  *   let alone called from multiple threads. Therefore, locking
@@ -1326,20 +1533,38 @@ int init(void)
 		return rc;
 	lua_script_path = get_extra_conf_path("job_submit.lua");
 
-	return slurm_lua_loadscript(&L, "job_submit/lua",
-				    lua_script_path, req_fxns,
-				    &lua_script_last_loaded,
-				    _loadscript_extra);
+	_get_config();
+	lua_states = xcalloc(lua_state_cnt, sizeof(lua_state_rec_t));
+	for (int i = 0; i < lua_state_cnt; i++) {
+		lua_state = &lua_states[i];
+		rc = slurm_lua_loadscript(&lua_state->L, "job_submit/lua",
+					  lua_script_path, req_fxns,
+					  &lua_state->load_time,
+					  _loadscript_extra);
+		if (rc != SLURM_SUCCESS)
+			break;
+	}
+	lua_state = NULL;
+
+	return rc;
 }
 
 int fini(void)
 {
-	if (L) {
-		debug3("%s: Unloading Lua script", __func__);
-		lua_close(L);
-		L = NULL;
-		lua_script_last_loaded = 0;
+	for (int i = 0; i < lua_state_cnt; i++) {
+		lua_state_rec_t *state = &lua_states[i];
+
+		if (state->call_cnt)
+			debug("%s: Lua state %d: calls:%u avg_usec:%"PRIu64" max_usec:%"PRIu64,
+			      plugin_type, i, state->call_cnt,
+			      state->call_time / state->call_cnt,
+			      state->call_time_max);
+		if (state->L) {
+			debug3("%s: Unloading Lua script", __func__);
+			lua_close(state->L);
+		}
 	}
+	xfree(lua_states);
 	xfree(lua_script_path);
 
 	slurm_lua_fini();
@@ -1353,11 +1578,10 @@ extern int job_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 		      char **err_msg)
 {
 	int rc;
-	slurm_mutex_lock (&lua_lock);
+	DEF_TIMERS;
 
-	rc = slurm_lua_loadscript(&L, "job_submit/lua",
-				  lua_script_path, req_fxns,
-				  &lua_script_last_loaded, _loadscript_extra);
+	START_TIMER;
+	rc = _acquire_lua_state();
 
 	if (rc != SLURM_SUCCESS)
 		goto out;
@@ -1370,7 +1594,9 @@ extern int job_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 	if (lua_isnil(L, -1))
 		goto out;
 
+#if LUA_VERSION_NUM < 502
 	_update_jobs_global(L);
+#endif
 	_update_resvs_global(L);
 
 	_push_job_desc(job_desc);
@@ -1398,7 +1624,8 @@ extern int job_submit(job_desc_msg_t *job_desc, uint32_t submit_uid,
 		user_msg = NULL;
 	}
 
-out:	slurm_mutex_unlock (&lua_lock);
+out:	END_TIMER;
+	_release_lua_state(DELTA_TIMER);
 	return rc;
 }
 
@@ -1407,11 +1634,10 @@ extern int job_modify(job_desc_msg_t *job_desc, job_record_t *job_ptr,
 		      uint32_t submit_uid, char **err_msg)
 {
 	int rc;
-	slurm_mutex_lock (&lua_lock);
+	DEF_TIMERS;
 
-	rc = slurm_lua_loadscript(&L, "job_submit/lua",
-				  lua_script_path, req_fxns,
-				  &lua_script_last_loaded, _loadscript_extra);
+	START_TIMER;
+	rc = _acquire_lua_state();
 
 	if (rc == SLURM_ERROR)
 		goto out;
@@ -1424,7 +1650,9 @@ extern int job_modify(job_desc_msg_t *job_desc, job_record_t *job_ptr,
 	if (lua_isnil(L, -1))
 		goto out;
 
+#if LUA_VERSION_NUM < 502
 	_update_jobs_global(L);
+#endif
 	_update_resvs_global(L);
 
 	_push_job_desc(job_desc);
@@ -1453,6 +1681,7 @@ extern int job_modify(job_desc_msg_t *job_desc, job_record_t *job_ptr,
 		user_msg = NULL;
 	}
 
-out:	slurm_mutex_unlock (&lua_lock);
+out:	END_TIMER;
+	_release_lua_state(DELTA_TIMER);
 	return rc;
 }
@@ -99,7 +99,17 @@ static pthread_cond_t  start_cond  = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t start_mutex = PTHREAD_MUTEX_INITIALIZER;
 static slurm_opt_t *opt_save = NULL;
 
+typedef struct {
+	slurm_step_id_t step_id;
+	uint32_t task_cnt;
+	uint32_t *task_node_inx;	/* layout node index of each task id */
+	char **node_names;		/* name of each layout node */
+	uint32_t node_cnt;
+} task_host_map_t;
+
 static List task_state_list = NULL;
+static List task_host_map_list = NULL;
+static pthread_mutex_t task_host_map_lock = PTHREAD_MUTEX_INITIALIZER;
 static time_t launch_start_time;
 static bool retry_step_begin = false;
 static int  retry_step_cnt = 0;
@@ -126,6 +136,75 @@ static char *_hostset_to_string(hostset_t hs)
 	return str;
 }
 
+static void _task_host_map_del(void *x)
+{
+	task_host_map_t *map = x;
+
+	for (int i = 0; i < map->node_cnt; i++)
+		xfree(map->node_names[i]);
+	xfree(map->node_names);
+	xfree(map->task_node_inx);
+	xfree(map);
+}
+
+static int _find_task_host_map(void *x, void *key)
+{
+	task_host_map_t *map = x;
+
+	return verify_step_id(&map->step_id, key);
+}
+
+/*
+ * Return the task id to host name map of my_srun_job's step, building it from
+ * the step layout on first use. The layout of a step never changes, so each
+ * task exit message can then be resolved without walking the whole layout.
+ */
+static task_host_map_t *_get_task_host_map(srun_job_t *my_srun_job,
+					   slurm_step_layout_t *sl)
+{
+	task_host_map_t *map;
+	hostlist_t hl;
+	hostlist_iterator_t itr;
+	char *host;
+	int i, j;
+
+	slurm_mutex_lock(&task_host_map_lock);
+	if (!task_host_map_list)
+		task_host_map_list = list_create(_task_host_map_del);
+	if ((map = list_find_first(task_host_map_list, _find_task_host_map,
+				   &my_srun_job->step_id))) {
+		slurm_mutex_unlock(&task_host_map_lock);
+		return map;
+	}
+
+	map = xmalloc(sizeof(*map));
+	memcpy(&map->step_id, &my_srun_job->step_id, sizeof(map->step_id));
+	map->task_cnt = sl->task_cnt;
+	map->task_node_inx = xcalloc(sl->task_cnt, sizeof(uint32_t));
+	for (i = 0; i < sl->task_cnt; i++)
+		map->task_node_inx[i] = NO_VAL;
+	map->node_names = xcalloc(sl->node_cnt, sizeof(char *));
+
+	hl = hostlist_create(sl->node_list);
+	itr = hostlist_iterator_create(hl);
+	for (i = 0; (i < sl->node_cnt) && (host = hostlist_next(itr)); i++) {
+		map->node_names[i] = xstrdup(host);
+		free(host);
+		for (j = 0; j < sl->tasks[i]; j++) {
+			if (sl->tids[i][j] < sl->task_cnt)
+				map->task_node_inx[sl->tids[i][j]] = i;
+		}
+	}
+	map->node_cnt = i;
+	hostlist_iterator_destroy(itr);
+	hostlist_destroy(hl);
+
+	list_append(task_host_map_list, map);
+	slurm_mutex_unlock(&task_host_map_lock);
+
+	return map;
+}
+
 /*
  * Convert an array of task IDs into a list of host names
  * RET: the string, caller must xfree() this value
@@ -133,37 +212,32 @@ static char *_hostset_to_string(hostset_t hs)
 static char *_task_ids_to_host_list(int ntasks, uint32_t *taskids,
 				    srun_job_t *my_srun_job)
 {
-	int i, task_cnt = 0;
+	int i;
+	uint32_t inx, last_inx = NO_VAL;
 	hostset_t hs;
 	char *hosts;
 	slurm_step_layout_t *sl;
+	task_host_map_t *map;
 
 	if ((sl = launch_common_get_slurm_step_layout(my_srun_job)) == NULL)
 		return (xstrdup("Unknown"));
-
-	/*
-	 * If overhead of determining the hostlist is too high then srun
-	 * communications will timeout and fail, so return "Unknown" instead.
-	 *
-	 * See slurm_step_layout_host_id() in src/common/slurm_step_layout.c
-	 * for details.
-	 */
-	for (i = 0; i < sl->node_cnt; i++) {
-		task_cnt += sl->tasks[i];
-	}
-	if (task_cnt > 100000)
+	if (!sl->task_cnt || !sl->tasks || !sl->tids)
 		return (xstrdup("Unknown"));
 
+	map = _get_task_host_map(my_srun_job, sl);
 	hs = hostset_create(NULL);
 	for (i = 0; i < ntasks; i++) {
-		char *host = slurm_step_layout_host_name(sl, taskids[i]);
-		if (host) {
-			hostset_insert(hs, host);
-			free(host);
-		} else {
+		if ((taskids[i] >= map->task_cnt) ||
+		    ((inx = map->task_node_inx[taskids[i]]) >= map->node_cnt)) {
 			error("Could not identify host name for task %u",
 			      taskids[i]);
+			continue;
 		}
+		/* Tasks in one exit message normally share a node */
+		if (inx == last_inx)
+			continue;
+		hostset_insert(hs, map->node_names[inx]);
+		last_inx = inx;
 	}
 
 	hosts = _hostset_to_string(hs);
@@ -548,6 +622,7 @@ extern int init(void)
 extern int fini(void)
 {
 	FREE_NULL_LIST(task_state_list);
+	FREE_NULL_LIST(task_host_map_list);
 
 	return SLURM_SUCCESS;
 }
@@ -194,9 +194,14 @@ extern int proctrack_p_signal (uint64_t id, int signal)
 		return cgroup_g_step_suspend();
 	}
 
-	/* start by resuming in case of SIGKILL */
+	/*
+	 * start by resuming in case of SIGKILL, then kill all the user
+	 * processes at once where the cgroup plugin supports it so that none
+	 * can escape by forking while we walk the pid list below
+	 */
 	if (signal == SIGKILL) {
 		cgroup_g_step_resume();
+		(void) cgroup_g_step_kill(0);
 	}
 
 	for (i = 0 ; i<npids ; i++) {
@@ -262,6 +267,14 @@ extern int proctrack_p_wait(uint64_t cont_id)
 	if (cont_id == 0 || cont_id == 1)
 		return SLURM_ERROR;
 
+	/*
+	 * Where supported, kill the user processes through the cgroup and
+	 * get notified once they are gone instead of polling with increasing
+	 * sleeps. Anything left over is handled below.
+	 */
+	cgroup_g_step_resume();
+	(void) cgroup_g_step_kill(slurm_conf.unkillable_timeout * 1000);
+
 	/*
 	 * Spin until the container is empty. This indicates that all tasks have
 	 * exited the container.
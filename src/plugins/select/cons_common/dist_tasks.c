@@ -124,6 +124,20 @@ static int _cmp_sock(const void *a, const void *b)
 	return (sockets_core_cnt[*(int*)b] - sockets_core_cnt[*(int*)a]);
 }
 
+/*
+ * Count the cores available to a job on one node, 0 if there are none.
+ * Counting is done a word at a time, so callers can detect nodes on which
+ * every available core is needed without walking the bitmap bit by bit.
+ */
+static uint32_t _node_core_cnt(bitstr_t *core_bitmap, uint32_t first_core,
+			       uint32_t core_cnt)
+{
+	if (!core_cnt)
+		return 0;
+	return bit_set_count_range(core_bitmap, first_core,
+				   first_core + core_cnt);
+}
+
 /* Enable detailed logging of cr_dist() node and core bitmaps */
 static inline void _log_select_maps(char *loc, job_record_t *job_ptr)
 {
@@ -568,6 +582,20 @@ static void _block_sync_core_bitmap(job_record_t *job_ptr,
 			int tasks = cpus / cpus_per_task;
 			req_cores = tasks * cores_per_task;
 		}
+		else if (!alloc_sockets &&
+			 (_node_core_cnt(job_res->core_bitmap, c, num_bits) ==
+			  req_cores)) {
+			/*
+			 * Every available core is needed, so the best-fit
+			 * search would keep them all.
+			 */
+			if (alloc_cores && (node_record_table_ptr[n]->tpc >= 1))
+				job_res->cpus[i] = req_cores *
+					node_record_table_ptr[n]->tpc;
+			i++;
+			c += num_bits;
+			continue;
+		}
 
 		if (nboards_nb > MAX_BOARDS) {
 			info("node[%u]: exceeds max boards(%d); doing best-fit across sockets only",
@@ -956,6 +984,23 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 		core_cnt = 0;
 		cpus = job_res->cpus[i];
 
+		if (!alloc_sockets && (ntasks_per_socket == INFINITE16) &&
+		    ((ntasks_per_core != 1) ||
+		     (job_ptr->details->cpus_per_task <= vpus)) &&
+		    (_node_core_cnt(core_map, c, sockets * cps) ==
+		     ((cpus + vpus - 1) / vpus))) {
+			/*
+			 * Every available core is needed, so the cyclic walk
+			 * over the sockets would keep them all.
+			 */
+			if (alloc_cores && (node_ptr->tpc >= 1))
+				job_res->cpus[i] = ((cpus + vpus - 1) / vpus) *
+						   node_ptr->tpc;
+			i++;
+			c += sockets * cps;
+			continue;
+		}
+
 		if (ntasks_per_socket != INFINITE16) {
 			int x_cpus, cpus_per_socket;
 			uint32_t total_cpus = 0;
@@ -38,25 +38,23 @@
 #include "../cons_common/dist_tasks.h"
 
 /*
- * Check if we're at job tasks_per_node limit for a given node when allocating
- * tasks to a node.
+ * Return the number of additional tasks that the job's tasks_per_node limit
+ * allows on a given node.
  *
- * RETURNS rc
- *  rc > 0 if tpn limit exceeded
- *  rc == 0 if exactly at tpn limit
- *  rc < 0 if not at limit yet
+ * RETURNS INFINITE if no limit is imposed, 0 if the limit is reached or
+ *	   exceeded (the latter is logged)
  */
-static int _at_tpn_limit(const uint32_t n, const job_record_t *job_ptr,
+static uint32_t _tpn_room(const uint32_t n, const job_record_t *job_ptr,
 			  const char *tag, bool log_error)
 {
 	const job_resources_t *job_res = job_ptr->job_resrcs;
 	const log_level_t log_lvl = log_error ? LOG_LEVEL_ERROR :
 						LOG_LEVEL_INFO;
-	int rc = -1;
+	int rc;
 
 	/* Special case where no limit is imposed - no overcommit */
 	if (job_ptr->details->ntasks_per_node == 0)
-		return rc;
+		return INFINITE;
 
 	rc = job_res->tasks_per_node[n] - job_ptr->details->ntasks_per_node;
 
@@ -68,7 +66,155 @@ static int _at_tpn_limit(const uint32_t n, const job_record_t *job_ptr,
 			tag, job_ptr, n, job_res->tasks_per_node[n],
 			job_ptr->details->ntasks_per_node);
 
-	return rc;
+	if (rc >= 0)
+		return 0;
+	return -rc;
+}
+
+/*
+ * Return the number of additional tasks that fit on a given node without
+ * oversubscribing its CPUs, nor exceeding the job's GRES or tasks_per_node
+ * limits.
+ */
+static uint32_t _task_room(const uint32_t n, const job_record_t *job_ptr,
+			   const uint32_t *gres_task_limit,
+			   const uint16_t *avail_cpus, const char *tag)
+{
+	const job_resources_t *job_res = job_ptr->job_resrcs;
+	uint16_t cpus_per_task = job_ptr->details->cpus_per_task;
+	uint32_t room;
+
+	if (avail_cpus[n] <= job_res->cpus[n])
+		return 0;
+	room = (avail_cpus[n] - job_res->cpus[n]) / cpus_per_task;
+
+	if (gres_task_limit) {
+		if (gres_task_limit[n] <= job_res->tasks_per_node[n])
+			return 0;
+		room = MIN(room, gres_task_limit[n] -
+				 job_res->tasks_per_node[n]);
+	}
+
+	return MIN(room, _tpn_room(n, job_ptr, tag, false));
+}
+
+/*
+ * Add task_cnt tasks to a node, consuming cpus_per_task CPUs for each of them
+ * while any CPU is left.
+ *
+ * RETURNS true if CPUs for another task remained after the first task was
+ *	   added
+ */
+static bool _add_tasks(job_resources_t *job_res, const uint16_t *avail_cpus,
+		       const uint32_t n, const uint32_t task_cnt,
+		       const uint16_t cpus_per_task)
+{
+	uint32_t first_cpus, cpus;
+
+	if (!task_cnt)
+		return false;
+
+	job_res->tasks_per_node[n] += task_cnt;
+	first_cpus = MIN(job_res->cpus[n] + cpus_per_task, avail_cpus[n]);
+	cpus = job_res->cpus[n] + (uint64_t) task_cnt * cpus_per_task;
+	job_res->cpus[n] = MIN(cpus, avail_cpus[n]);
+
+	return ((avail_cpus[n] - first_cpus) >= cpus_per_task);
+}
+
+/*
+ * Tasks placed on a node after "rounds" passes of the core-packing
+ * distribution loop in dist_tasks_compute_c_b(), which adds up to "chunk"
+ * tasks per pass until "room" is exhausted.
+ */
+static inline uint64_t _round_tasks(uint64_t rounds, uint32_t chunk,
+				    uint32_t room)
+{
+	return MIN(rounds * chunk, room);
+}
+
+/*
+ * Compute arithmetically the outcome of as many complete passes of the
+ * core-packing loop in dist_tasks_compute_c_b() as possible and apply them
+ * in a single sweep over the nodes. A pass is only applied if the job's
+ * remaining tasks are not exhausted before its end and if the previous pass
+ * left room on some node (otherwise the loop would switch to oversubscription
+ * mode). The remaining partial pass is left to the caller.
+ *
+ * IN/OUT job_ptr - job being distributed, tasks_per_node and cpus updated
+ * IN gres_task_limit - per node task limits based upon GRES, may be NULL
+ * IN avail_cpus - CPUs available to the job on each node
+ * IN vpus - threads per core of each node
+ * IN rem_tasks - tasks still to be distributed
+ * OUT over_subscribe - set if no room was left after the last applied pass
+ * RETURN number of tasks distributed
+ */
+static uint32_t _dist_full_rounds(job_record_t *job_ptr,
+				  uint32_t *gres_task_limit,
+				  uint16_t *avail_cpus, uint16_t *vpus,
+				  uint32_t rem_tasks, bool *over_subscribe)
+{
+	job_resources_t *job_res = job_ptr->job_resrcs;
+	uint16_t cpus_per_task = job_ptr->details->cpus_per_task;
+	uint64_t lo = 0, hi = 0, mid, sum;
+	uint32_t n, chunk, room, cpu_room, added = 0;
+	bool room_left;
+
+	/* Passes after which no node can take another task */
+	for (n = 0; n < job_res->nhosts; n++) {
+		chunk = MAX(vpus[n] / cpus_per_task, 1);
+		room = _task_room(n, job_ptr, gres_task_limit, avail_cpus,
+				  "fill additional");
+		hi = MAX(hi, (room + chunk - 1) / chunk);
+	}
+
+	/*
+	 * Binary search for the largest number of passes that may be applied,
+	 * both constraints being monotonic in the number of passes.
+	 */
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		sum = 0;
+		room_left = (mid <= 1);
+		for (n = 0; n < job_res->nhosts; n++) {
+			chunk = MAX(vpus[n] / cpus_per_task, 1);
+			room = _task_room(n, job_ptr, gres_task_limit,
+					  avail_cpus, "fill additional");
+			sum += _round_tasks(mid, chunk, room);
+			if (room_left || (((mid - 2) * chunk) >= room))
+				continue;
+			cpu_room = (avail_cpus[n] - job_res->cpus[n]) /
+				   cpus_per_task;
+			if ((cpu_room - ((mid - 2) * chunk)) >= 2)
+				room_left = true;
+		}
+		if ((sum <= rem_tasks) && room_left)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	if (!lo)
+		return 0;
+
+	room_left = false;
+	for (n = 0; n < job_res->nhosts; n++) {
+		chunk = MAX(vpus[n] / cpus_per_task, 1);
+		room = _task_room(n, job_ptr, gres_task_limit, avail_cpus,
+				  "fill additional");
+		cpu_room = (avail_cpus[n] - job_res->cpus[n]) / cpus_per_task;
+		/* Did the last pass add a task leaving room for another? */
+		if ((((lo - 1) * chunk) < room) &&
+		    ((cpu_room - ((lo - 1) * chunk)) >= 2))
+			room_left = true;
+		sum = _round_tasks(lo, chunk, room);
+		(void) _add_tasks(job_res, avail_cpus, n, sum, cpus_per_task);
+		added += sum;
+	}
+	if (!room_left)
+		*over_subscribe = true;
+
+	return added;
 }
 
 /*
@@ -93,14 +239,13 @@ extern int dist_tasks_compute_c_b(job_record_t *job_ptr,
 				  uint32_t *gres_task_limit)
 {
 	bool over_subscribe = false;
-	uint32_t n, tid, t, maxtasks, l;
+	uint32_t n, tid, maxtasks, task_cnt;
 	uint16_t *avail_cpus;
 	job_resources_t *job_res = job_ptr->job_resrcs;
-	bool log_over_subscribe = true;
 	char *err_msg = NULL;
 	uint16_t *vpus;
 	bool space_remaining;
-	int rem_cpus, rem_tasks;
+	uint32_t rem_cpus, rem_tasks;
 	uint16_t cpus_per_task;
 	node_record_t *node_ptr;
 
@@ -151,8 +296,6 @@ extern int dist_tasks_compute_c_b(job_record_t *job_ptr,
 		      job_ptr);
 		maxtasks = 1;
 	}
-	if (job_ptr->details->overcommit)
-		log_over_subscribe = false;
 	/* Start by allocating one task per node */
 	space_remaining = false;
 	tid = 0;
@@ -161,10 +304,7 @@ extern int dist_tasks_compute_c_b(job_record_t *job_ptr,
 			/* Ignore gres_task_limit for first task per node */
 			tid++;
 			job_res->tasks_per_node[n]++;
-			for (l = 0; l < cpus_per_task; l++) {
-				if (job_res->cpus[n] < avail_cpus[n])
-					job_res->cpus[n]++;
-			}
+			job_res->cpus[n] = MIN(cpus_per_task, avail_cpus[n]);
 			if (job_res->cpus[n] < avail_cpus[n])
 				space_remaining = true;
 		}
@@ -178,23 +318,13 @@ extern int dist_tasks_compute_c_b(job_record_t *job_ptr,
 		rem_tasks = rem_cpus / cpus_per_task;
 		if (rem_tasks == 0)
 			continue;
-		for (t = 0; ((t < rem_tasks) && (tid < maxtasks)); t++) {
-			if (((avail_cpus[n] - job_res->cpus[n]) <
-			     cpus_per_task))
-				break;
-			if (!dist_tasks_tres_tasks_avail(
-				    gres_task_limit, job_res, n))
-				break;
-			if (_at_tpn_limit(n, job_ptr, "fill allocated",
-					  false) >= 0)
-				break;
-			tid++;
-			job_res->tasks_per_node[n]++;
-			for (l = 0; l < cpus_per_task; l++) {
-				if (job_res->cpus[n] < avail_cpus[n])
-					job_res->cpus[n]++;
-			}
-		}
+		task_cnt = _task_room(n, job_ptr, gres_task_limit, avail_cpus,
+				      "fill allocated");
+		task_cnt = MIN(task_cnt, rem_tasks);
+		task_cnt = MIN(task_cnt, maxtasks - tid);
+		(void) _add_tasks(job_res, avail_cpus, n, task_cnt,
+				  cpus_per_task);
+		tid += task_cnt;
 	}
 
 	/*
@@ -205,54 +335,37 @@ extern int dist_tasks_compute_c_b(job_record_t *job_ptr,
 	 * cores on other nodes. So "srun -n20 hostname" should not launch 7
 	 * tasks on node 0, 7 tasks on node 1, and 6 tasks on node 2.  It should
 	 * launch 8 tasks on node, 8 tasks on node 1, and 4 tasks on node 2.
+	 *
+	 * Complete passes over the nodes are computed up front, so the loop
+	 * below usually only runs the last partial pass.
 	 */
 	if (job_ptr->details->overcommit && !job_ptr->tres_per_task)
 		maxtasks = 0;	/* Allocate have one_task_per_node */
+	if ((tid < maxtasks) && !over_subscribe)
+		tid += _dist_full_rounds(job_ptr, gres_task_limit, avail_cpus,
+					 vpus, maxtasks - tid, &over_subscribe);
 	while (tid < maxtasks) {
+		/*
+		 * 'over_subscribe' is a relief valve that guards against an
+		 * infinite loop, and it *should* never come into play because
+		 * maxtasks should never be greater than the total number of
+		 * available CPUs
+		 */
 		bool space_remaining = false;
-		int over_limit = -1;
-		if (over_subscribe && log_over_subscribe && (over_limit > 0)) {
-			/*
-			 * 'over_subscribe' is a relief valve that guards
-			 * against an infinite loop, and it *should* never
-			 * come into play because maxtasks should never be
-			 * greater than the total number of available CPUs
-			 */
-			error("oversubscribe for %pJ",
-			      job_ptr);
-			log_over_subscribe = false;	/* Log once per job */;
-		}
 		for (n = 0; ((n < job_res->nhosts) && (tid < maxtasks)); n++) {
 			rem_tasks = vpus[n] / cpus_per_task;
-			rem_tasks = MAX(rem_tasks, 1);
-			for (t = 0; ((t < rem_tasks) && (tid < maxtasks)); t++){
-				if (!over_subscribe) {
-					if ((avail_cpus[n] - job_res->cpus[n]) <
-					    cpus_per_task)
-						break;
-					if (!dist_tasks_tres_tasks_avail(
-						    gres_task_limit,
-						    job_res, n))
-						break;
-					over_limit = _at_tpn_limit(
-						n, job_ptr,
-						"fill additional",
-						false);
-					if (over_limit >= 0)
-						break;
-				}
-
-				tid++;
-				job_res->tasks_per_node[n]++;
-				for (l = 0; l < cpus_per_task;
-				     l++) {
-					if (job_res->cpus[n] < avail_cpus[n])
-						job_res->cpus[n]++;
-				}
-				if ((avail_cpus[n] - job_res->cpus[n]) >=
-				    cpus_per_task)
-					space_remaining = true;
-			}
+			task_cnt = MAX(rem_tasks, 1);
+			if (!over_subscribe)
+				task_cnt = MIN(task_cnt,
+					       _task_room(n, job_ptr,
+							  gres_task_limit,
+							  avail_cpus,
+							  "fill additional"));
+			task_cnt = MIN(task_cnt, maxtasks - tid);
+			if (_add_tasks(job_res, avail_cpus, n, task_cnt,
+				       cpus_per_task))
+				space_remaining = true;
+			tid += task_cnt;
 		}
 		if (!space_remaining)
 			over_subscribe = true;
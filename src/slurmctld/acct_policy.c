@@ -3766,15 +3766,18 @@ extern bool acct_policy_job_runnable_post_select(job_record_t *job_ptr,
 
 	acct_policy_set_qos_order(job_ptr, &qos_ptr_1, &qos_ptr_2);
 
-	/* check the first QOS setting it's values in the qos_rec */
-	if (qos_ptr_1 &&
+	/*
+	 * check the first QOS setting it's values in the qos_rec, a QOS
+	 * without TRES limits has nothing to check or set here
+	 */
+	if (qos_ptr_1 && !qos_ptr_1->usage->no_tres_limits &&
 	    !(rc = _qos_job_runnable_post_select(job_ptr, qos_ptr_1,
 						 &qos_rec, tres_req_cnt,
 						 job_tres_time_limit)))
 		goto end_it;
 
 	/* If qos_ptr_1 didn't set the value use the 2nd QOS to set the limit */
-	if (qos_ptr_2 &&
+	if (qos_ptr_2 && !qos_ptr_2->usage->no_tres_limits &&
 	    !(rc = _qos_job_runnable_post_select(job_ptr, qos_ptr_2,
 						 &qos_rec, tres_req_cnt,
 						 job_tres_time_limit)))
@@ -3787,6 +3790,17 @@ extern bool acct_policy_job_runnable_post_select(job_record_t *job_ptr,
 
 	assoc_ptr = job_ptr->assoc_ptr;
 	while (assoc_ptr) {
+		/*
+		 * Every check below is against the association's TRES
+		 * limits, so skip the usage conversion and checks when none
+		 * are set (typically most of the hierarchy).
+		 */
+		if (assoc_ptr->usage->no_tres_limits) {
+			assoc_ptr = assoc_ptr->usage->parent_assoc_ptr;
+			parent = 1;
+			continue;
+		}
+
 		for (i = 0; i < slurmctld_tres_cnt; i++) {
 			tres_usage_mins[i] =
 				(uint64_t)(assoc_ptr->usage->usage_tres_raw[i]
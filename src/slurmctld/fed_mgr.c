@@ -63,6 +63,7 @@
 #define FED_MGR_STATE_FILE       "fed_mgr_state"
 #define FED_MGR_CLUSTER_ID_BEGIN 26
 #define TEST_REMOTE_DEP_FREQ 30 /* seconds */
+#define FED_AGENT_MAX_DEFER  32 /* seconds, max sibling send backoff */
 
 #define FED_SIBLING_BIT(x) ((uint64_t)1 << (x - 1))
 
@@ -377,6 +378,15 @@ static int _open_controller_conn(slurmdb_cluster_rec_t *cluster, bool locked)
 	} else {
 		log_flag(FEDR, "opened sibling conn to %s:%d",
 			 cluster->name, persist_conn->fd);
+		/* The sibling is back, send queued RPCs right away */
+		if (cluster->send_rpc_retry) {
+			cluster->send_rpc_defer = 0;
+			cluster->send_rpc_retry = 0;
+			slurm_mutex_lock(&agent_mutex);
+			agent_queue_size++;
+			slurm_cond_broadcast(&agent_cond);
+			slurm_mutex_unlock(&agent_mutex);
+		}
 	}
 
 	if (!locked)
@@ -756,6 +766,10 @@ static void _fed_mgr_ptr_init(slurmdb_federation_rec_t *db_fed,
 			tmp_cluster->fed.recv = NULL;
 			db_cluster->send_rpc = tmp_cluster->send_rpc;
 			tmp_cluster->send_rpc = NULL;
+			db_cluster->send_rpc_defer =
+				tmp_cluster->send_rpc_defer;
+			db_cluster->send_rpc_retry =
+				tmp_cluster->send_rpc_retry;
 			db_cluster->fed.sync_sent =
 				tmp_cluster->fed.sync_sent;
 			db_cluster->fed.sync_recvd =
@@ -1740,6 +1754,7 @@ static void _do_fed_job_complete(job_record_t *job_ptr, uint32_t job_state,
 		 * state in place. JOB_SPECIAL_EXIT may be in the
 		 * states. */
 		job_ptr->job_state &= ~(JOB_PENDING | JOB_COMPLETING);
+		retest_job_dependents(job_ptr);
 		batch_requeue_fini(job_ptr);
 	} else {
 		fed_mgr_job_revoke(job_ptr, true, job_state, exit_code,
@@ -2543,6 +2558,7 @@ static void *_agent_thread(void *arg)
 	ctld_list_msg_t ctld_req_msg;
 	bitstr_t *success_bits;
 	int rc, resp_inx, success_size;
+	bool deferred;
 
 	slurmctld_lock_t fed_read_lock = {
 		NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK, READ_LOCK };
@@ -2580,6 +2596,17 @@ static void *_agent_thread(void *arg)
 			if ((cluster->send_rpc == NULL) ||
 			   (list_count(cluster->send_rpc) == 0))
 				continue;
+			/*
+			 * Per-sibling backoff after a failed send. While a
+			 * sibling is unreachable, newly queued RPCs are held
+			 * rather than each one triggering another connection
+			 * attempt. Cleared by _open_controller_conn().
+			 */
+			slurm_mutex_lock(&cluster->lock);
+			deferred = (cluster->send_rpc_retry > now);
+			slurm_mutex_unlock(&cluster->lock);
+			if (deferred)
+				continue;
 
 			/* Move currently pending RPCs to new list */
 			ctld_req_msg.my_list = NULL;
@@ -2615,6 +2642,21 @@ static void *_agent_thread(void *arg)
 			rc = _send_recv_msg(cluster, &req_msg, &resp_msg,
 					    false);
 
+			slurm_mutex_lock(&cluster->lock);
+			if (rc == SLURM_SUCCESS) {
+				cluster->send_rpc_defer = 0;
+				cluster->send_rpc_retry = 0;
+			} else {
+				if (!cluster->send_rpc_defer)
+					cluster->send_rpc_defer = 2;
+				else if (cluster->send_rpc_defer <
+					 FED_AGENT_MAX_DEFER)
+					cluster->send_rpc_defer *= 2;
+				cluster->send_rpc_retry =
+					now + cluster->send_rpc_defer;
+			}
+			slurm_mutex_unlock(&cluster->lock);
+
 			/* Process the response */
 			if ((rc == SLURM_SUCCESS) &&
 			    (resp_msg.msg_type == RESPONSE_CTLD_MULT_MSG)) {
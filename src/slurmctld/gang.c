@@ -391,7 +391,6 @@ static int _job_fits_in_active_row(job_record_t *job_ptr,
 {
 	job_resources_t *job_res = job_ptr->job_resrcs;
 	int count;
-	bitstr_t *job_map;
 	uint16_t job_gr_type;
 
 	if ((p_ptr->active_resmap == NULL) || (p_ptr->jobs_active == 0))
@@ -405,12 +404,9 @@ static int _job_fits_in_active_row(job_record_t *job_ptr,
 	}
 
 	/* job_gr_type == GS_NODE || job_gr_type == GS_CPU */
-	job_map = bit_copy(job_res->node_bitmap);
-	bit_and(job_map, p_ptr->active_resmap);
-	/* any set bits indicate contention for the same resource */
-	count = bit_set_count(job_map);
+	/* any common bits indicate contention for the same resource */
+	count = bit_overlap(job_res->node_bitmap, p_ptr->active_resmap);
 	log_flag(GANG, "gang: %s: %d bits conflict", __func__, count);
-	FREE_NULL_BITMAP(job_map);
 	if (count == 0)
 		return 1;
 	if (job_gr_type == GS_CPU) {
@@ -500,34 +496,24 @@ static void _add_job_to_active(job_record_t *job_ptr, struct gs_part *p_ptr)
 
 	/* add job to the active_cpus array */
 	if (job_gr_type == GS_CPU) {
-		uint32_t i, a, sz = bit_size(p_ptr->active_resmap);
+		uint32_t a, sz = bit_size(p_ptr->active_resmap);
 		if (!p_ptr->active_cpus) {
 			/* create active_cpus array */
 			p_ptr->active_cpus = xmalloc(sz * sizeof(uint16_t));
+		} else if (p_ptr->jobs_active == 0) {
+			/* clear the existing values in active_cpus */
+			memset(p_ptr->active_cpus, 0, sz * sizeof(uint16_t));
 		}
-		if (p_ptr->jobs_active == 0) {
-			/* overwrite the existing values in active_cpus */
-			for (a = 0, i = 0; i < sz; i++) {
-				if (bit_test(job_res->node_bitmap, i)) {
-					p_ptr->active_cpus[i] =
-						job_res->cpus[a++];
-				} else {
-					p_ptr->active_cpus[i] = 0;
-				}
-			}
-		} else {
-			/* add job to existing jobs in the active cpus */
-			for (a = 0, i = 0; i < sz; i++) {
-				if (bit_test(job_res->node_bitmap, i)) {
-					uint16_t limit = _get_phys_bit_cnt(i);
-					p_ptr->active_cpus[i] +=
-						job_res->cpus[a++];
-					/* when adding shadows, the resources
-					 * may get overcommitted */
-					if (p_ptr->active_cpus[i] > limit)
-						p_ptr->active_cpus[i] = limit;
-				}
-			}
+		/* add job to existing jobs in the active cpus */
+		a = 0;
+		for (int i = 0; next_node_bitmap(job_res->node_bitmap, &i);
+		     i++) {
+			uint16_t limit = _get_phys_bit_cnt(i);
+			p_ptr->active_cpus[i] += job_res->cpus[a++];
+			/* when adding shadows, the resources
+			 * may get overcommitted */
+			if (p_ptr->active_cpus[i] > limit)
+				p_ptr->active_cpus[i] = limit;
 		}
 	}
 	p_ptr->jobs_active += 1;
@@ -1423,26 +1409,32 @@ static void _build_active_row(struct gs_part *p_ptr)
  */
 static void _cycle_job_list(struct gs_part *p_ptr)
 {
-	int i, j;
-	struct gs_job *j_ptr;
+	int i, j, k;
+	struct gs_job *j_ptr, **active_jobs = NULL;
 	uint16_t preempt_mode;
 
 	log_flag(GANG, "gang: entering %s", __func__);
-	/* re-prioritize the job_list and set all row_states to GS_NO_ACTIVE */
-	for (i = 0; i < p_ptr->num_jobs; i++) {
-		while (p_ptr->job_list[i]->row_state == GS_ACTIVE) {
-			/* move this job to the back row and "deactivate" it */
-			j_ptr = p_ptr->job_list[i];
-			j_ptr->row_state = GS_NO_ACTIVE;
-			for (j = i; j+1 < p_ptr->num_jobs; j++) {
-				p_ptr->job_list[j] = p_ptr->job_list[j+1];
-			}
-			p_ptr->job_list[j] = j_ptr;
+	/*
+	 * re-prioritize the job_list and set all row_states to GS_NO_ACTIVE:
+	 * move the active jobs to the back row, preserving their order among
+	 * each other, in a single pass over the job_list
+	 */
+	if (p_ptr->num_jobs)
+		active_jobs = xcalloc(p_ptr->num_jobs,
+				      sizeof(struct gs_job *));
+	for (i = 0, j = 0, k = 0; i < p_ptr->num_jobs; i++) {
+		j_ptr = p_ptr->job_list[i];
+		if (j_ptr->row_state == GS_ACTIVE) {
+			active_jobs[k++] = j_ptr;
+		} else {
+			p_ptr->job_list[j++] = j_ptr;
 		}
-		if (p_ptr->job_list[i]->row_state == GS_FILLER)
-			p_ptr->job_list[i]->row_state = GS_NO_ACTIVE;
-
+		j_ptr->row_state = GS_NO_ACTIVE;
 	}
+	if (k)
+		memcpy(&p_ptr->job_list[j], active_jobs,
+		       k * sizeof(struct gs_job *));
+	xfree(active_jobs);
 	log_flag(GANG, "gang: %s reordered job list:", __func__);
 	/* Rebuild the active row. */
 	_build_active_row(p_ptr);
@@ -2611,6 +2611,8 @@ static int _load_job_state(buf_t *buffer, uint16_t protocol_version)
 
 	_add_job_hash(job_ptr);
 	_add_job_array_hash(job_ptr);
+	if (IS_JOB_RUNNING(job_ptr) || IS_JOB_SUSPENDED(job_ptr))
+		slurm_preempt_job_started(job_ptr);
 
 	memset(&assoc_rec, 0, sizeof(assoc_rec));
 
@@ -4673,6 +4675,9 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	save_prio_factors = job_ptr_pend->prio_factors;
 	save_step_list = job_ptr_pend->step_list;
 	memcpy(job_ptr_pend, job_ptr, sizeof(job_record_t));
+	/* Jobs depending on the array stay registered with job_ptr_pend */
+	job_ptr->dependent_ids = NULL;
+	job_ptr->dependent_cnt = 0;
 
 	job_ptr_pend->job_id   = save_job_id;
 	job_ptr_pend->details  = save_details;
@@ -9924,6 +9929,7 @@ static void _list_delete_job(void *job_entry)
 	xfree(job_ptr->container);
 	xfree(job_ptr->clusters);
 	xfree(job_ptr->cpus_per_tres);
+	xfree(job_ptr->dependent_ids);
 	free_job_fed_details(&job_ptr->fed_details);
 	free_job_resources(&job_ptr->job_resrcs);
 	_clear_job_gres_details(job_ptr);
@@ -16244,6 +16250,7 @@ extern void job_completion_logger(job_record_t *job_ptr, bool requeue)
 
 	xassert(job_ptr);
 
+	retest_job_dependents(job_ptr);
 	acct_policy_remove_job_submit(job_ptr);
 	if (job_ptr->nodes && ((job_ptr->bit_flags & JOB_KILL_HURRY) == 0)
 	    && !IS_JOB_RESIZING(job_ptr)) {
@@ -17336,8 +17343,10 @@ static int _job_requeue_op(uid_t uid, job_record_t *job_ptr, bool preempt,
 		if (!IS_JOB_COMPLETING(job_ptr) && !job_ptr->fed_details &&
 		    job_ptr->db_index)
 			is_completed = true;
-		else
+		else {
 			job_ptr->job_state &= (~JOB_COMPLETING);
+			retest_job_dependents(job_ptr);
+		}
 	}
 
 	_set_requeued_job_pending_completing(job_ptr);
@@ -18286,12 +18295,15 @@ extern void build_cg_bitmap(job_record_t *job_ptr)
 	FREE_NULL_BITMAP(job_ptr->node_bitmap_cg);
 	if (job_ptr->node_bitmap) {
 		job_ptr->node_bitmap_cg = bit_copy(job_ptr->node_bitmap);
-		if (bit_ffs(job_ptr->node_bitmap_cg) == -1)
+		if (bit_ffs(job_ptr->node_bitmap_cg) == -1) {
 			job_ptr->job_state &= (~JOB_COMPLETING);
+			retest_job_dependents(job_ptr);
+		}
 	} else {
 		error("build_cg_bitmap: node_bitmap is NULL");
 		job_ptr->node_bitmap_cg = bit_alloc(node_record_count);
 		job_ptr->job_state &= (~JOB_COMPLETING);
+		retest_job_dependents(job_ptr);
 	}
 }
 
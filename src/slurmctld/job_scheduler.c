@@ -99,6 +99,7 @@
 #endif
 #define BUILD_TIMEOUT 2000000	/* Max build_job_queue() run time in usec */
 #define MAX_FAILED_RESV 10
+#define DEPEND_CACHE_TIME 60	/* Max age of a reused dependency test, sec */
 
 static batch_job_launch_msg_t *_build_launch_job_msg(job_record_t *job_ptr,
 						     uint16_t protocol_version);
@@ -467,9 +468,11 @@ extern List build_job_queue(bool clear_start, bool backfill)
 
 	/*
 	 * Create individual job records for job arrays that need burst buffer
-	 * staging
+	 * staging or have depend_type == SLURM_DEPEND_AFTER_CORRESPOND. Both
+	 * are handled in a single pass so that large job_lists, such as those
+	 * with many job array tasks, are not walked an extra time here.
 	 *
-	 * NOTE: You can not use list_for_each for these loops here because
+	 * NOTE: You can not use list_for_each for this loop here because
 	 * job_array_post_sched and job_array_split could eventually call
 	 * _create_job_record which appends to job_list causing deadlock.  The
 	 * last one calls job_independent from _job_runnable_test1 which
@@ -478,56 +481,45 @@ extern List build_job_queue(bool clear_start, bool backfill)
 	 */
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = list_next(job_iterator))) {
-		if (!IS_JOB_PENDING(job_ptr) ||
-		    !job_ptr->burst_buffer || !job_ptr->array_recs ||
+		if (!job_ptr->array_recs || !IS_JOB_PENDING(job_ptr) ||
 		    !job_ptr->array_recs->task_id_bitmap ||
 		    (job_ptr->array_task_id != NO_VAL))
 			continue;
 
 		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
 			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= bb_array_stage_cnt)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
+
+		if (job_ptr->burst_buffer &&
+		    (job_ptr->array_recs->task_cnt >= 1) &&
+		    (num_pending_job_array_tasks(job_ptr->array_job_id) <
+		     bb_array_stage_cnt)) {
+			if (job_ptr->array_recs->task_cnt == 1) {
+				job_ptr->array_task_id = i;
+				(void) job_array_post_sched(job_ptr);
+				if (job_ptr->details &&
+				    job_ptr->details->dependency &&
+				    job_ptr->details->depend_list)
+					fed_mgr_submit_remote_dependencies(
+						job_ptr, false, false);
+				continue;
+			}
 			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			if (job_ptr->details && job_ptr->details->dependency &&
-			    job_ptr->details->depend_list)
-				fed_mgr_submit_remote_dependencies(job_ptr,
-								   false,
-								   false);
+			new_job_ptr = job_array_split(job_ptr);
+			if (new_job_ptr) {
+				debug("%s: Split out %pJ for burst buffer use",
+				      __func__, job_ptr);
+				new_job_ptr->job_state = JOB_PENDING;
+				new_job_ptr->start_time = (time_t) 0;
+				/* Do NOT clear db_index here, it is handled
+				 * when task_id_str is created elsewhere */
+				(void) bb_g_job_validate2(job_ptr, NULL);
+			} else {
+				error("%s: Unable to copy record for %pJ",
+				      __func__, job_ptr);
+			}
 			continue;
 		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		if (new_job_ptr) {
-			debug("%s: Split out %pJ for burst buffer use",
-			      __func__, job_ptr);
-			new_job_ptr->job_state = JOB_PENDING;
-			new_job_ptr->start_time = (time_t) 0;
-			/* Do NOT clear db_index here, it is handled when
-			 * task_id_str is created elsewhere */
-			(void) bb_g_job_validate2(job_ptr, NULL);
-		} else {
-			error("%s: Unable to copy record for %pJ",
-			      __func__, job_ptr);
-		}
-	}
 
-	/* Create individual job records for job arrays with
-	 * depend_type == SLURM_DEPEND_AFTER_CORRESPOND */
-	list_iterator_reset(job_iterator);
-	while ((job_ptr = list_next(job_iterator))) {
-		if (!IS_JOB_PENDING(job_ptr) ||
-		    !job_ptr->array_recs ||
-		    !job_ptr->array_recs->task_id_bitmap ||
-		    (job_ptr->array_task_id != NO_VAL))
-			continue;
-		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
-			continue;
 		if ((job_ptr->details == NULL) ||
 		    (job_ptr->details->depend_list == NULL) ||
 		    (list_count(job_ptr->details->depend_list) == 0))
@@ -542,6 +534,7 @@ extern List build_job_queue(bool clear_start, bool backfill)
 				break;
 			}
 		}
+		list_iterator_destroy(depend_iter);
 		if (!dep_corr)
 			continue;
 		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
@@ -2986,6 +2979,121 @@ static void _test_dependency_state(depend_spec_t *dep_ptr, bool *or_satisfied,
 	}
 }
 
+/*
+ * Return true if an unfulfilled dependency can only change state when the
+ * job it depends upon changes state, which retest_job_dependents() reports.
+ */
+static bool _depend_event_driven(depend_spec_t *dep_ptr)
+{
+	if (dep_ptr->depend_flags & SLURM_FLAGS_REMOTE)
+		return false;
+
+	switch (dep_ptr->depend_type) {
+	case SLURM_DEPEND_AFTER:
+		return !dep_ptr->depend_time;
+	case SLURM_DEPEND_AFTER_ANY:
+	case SLURM_DEPEND_AFTER_NOT_OK:
+	case SLURM_DEPEND_AFTER_OK:
+	case SLURM_DEPEND_AFTER_CORRESPOND:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Append job_id to djob_ptr's dependent_ids. A job re-registers with every
+ * job it depends upon once any one of them changes state, so duplicates and
+ * ids of purged jobs may accumulate here; _retest_dependents() tolerates
+ * both, which is cheaper than searching the array on each registration.
+ */
+static void _add_dependent_id(job_record_t *djob_ptr, uint32_t job_id)
+{
+	uint32_t cnt = djob_ptr->dependent_cnt;
+
+	/* Grow by powers of two */
+	if (!(cnt & (cnt - 1)))
+		xrecalloc(djob_ptr->dependent_ids, (cnt ? (cnt * 2) : 1),
+			  sizeof(uint32_t));
+	djob_ptr->dependent_ids[djob_ptr->dependent_cnt++] = job_id;
+}
+
+/*
+ * Remember that job_ptr's dependencies were just tested with a LOCAL_DEPEND
+ * result which can only change after a state change of a job it depends
+ * upon. Register job_ptr with each of those jobs so that
+ * retest_job_dependents() invalidates the result.
+ */
+static void _cache_depend_result(job_record_t *job_ptr)
+{
+	struct job_details *detail_ptr = job_ptr->details;
+	ListIterator depend_iter;
+	depend_spec_t *dep_ptr;
+	job_record_t *djob_ptr;
+
+	if (detail_ptr->depend_reg_job_id != job_ptr->job_id) {
+		/* Every job depended upon must be able to notify us */
+		depend_iter = list_iterator_create(detail_ptr->depend_list);
+		while ((dep_ptr = list_next(depend_iter))) {
+			if ((dep_ptr->depend_state == DEPEND_NOT_FULFILLED) &&
+			    !find_job_record(dep_ptr->job_id))
+				break;
+		}
+		list_iterator_destroy(depend_iter);
+		if (dep_ptr) {
+			detail_ptr->depend_test_time = 0;
+			return;
+		}
+
+		depend_iter = list_iterator_create(detail_ptr->depend_list);
+		while ((dep_ptr = list_next(depend_iter))) {
+			if (dep_ptr->depend_state != DEPEND_NOT_FULFILLED)
+				continue;
+			djob_ptr = find_job_record(dep_ptr->job_id);
+			_add_dependent_id(djob_ptr, job_ptr->job_id);
+		}
+		list_iterator_destroy(depend_iter);
+		detail_ptr->depend_reg_job_id = job_ptr->job_id;
+	}
+	detail_ptr->depend_test_time = time(NULL);
+}
+
+static void _retest_dependents(job_record_t *djob_ptr)
+{
+	job_record_t *job_ptr;
+
+	for (int i = 0; i < djob_ptr->dependent_cnt; i++) {
+		if (!(job_ptr = find_job_record(djob_ptr->dependent_ids[i])) ||
+		    !job_ptr->details)
+			continue;
+		job_ptr->details->depend_reg_job_id = 0;
+		job_ptr->details->depend_test_time = 0;
+	}
+	xfree(djob_ptr->dependent_ids);
+	djob_ptr->dependent_cnt = 0;
+}
+
+/*
+ * Invalidate the cached dependency test of every job waiting on a state
+ * change of job_ptr, its job array or its heterogeneous job.
+ */
+extern void retest_job_dependents(job_record_t *job_ptr)
+{
+	job_record_t *djob_ptr;
+
+	if (job_ptr->dependent_cnt)
+		_retest_dependents(job_ptr);
+	if ((job_ptr->array_task_id != NO_VAL) &&
+	    (job_ptr->array_job_id != job_ptr->job_id) &&
+	    (djob_ptr = find_job_record(job_ptr->array_job_id)) &&
+	    djob_ptr->dependent_cnt)
+		_retest_dependents(djob_ptr);
+	if (job_ptr->het_job_id && (job_ptr->het_job_id != job_ptr->job_id) &&
+	    (djob_ptr = find_job_record(job_ptr->het_job_id)) &&
+	    djob_ptr->dependent_cnt)
+		_retest_dependents(djob_ptr);
+}
+
 /*
  * Determine if a job's dependencies are met
  * Inputs: job_ptr
@@ -3008,6 +3116,7 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 	bool is_complete, is_completed, is_pending;
 	bool or_satisfied = false, and_failed = false, or_flag = false,
 	     has_unfulfilled = false, changed = false;
+	bool event_driven = !fed_mgr_fed_rec;
 
 	if ((job_ptr->details == NULL) ||
 	    (job_ptr->details->depend_list == NULL) ||
@@ -3018,6 +3127,23 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 		return NO_DEPEND;
 	}
 
+	/*
+	 * Nothing the remaining dependencies wait on has changed state since
+	 * the last test, see retest_job_dependents(). Time out the result
+	 * anyway in case some state change was not reported.
+	 */
+	if (job_ptr->details->depend_test_time &&
+	    (job_ptr->details->depend_reg_job_id == job_ptr->job_id) &&
+	    ((time(NULL) - job_ptr->details->depend_test_time) <
+	     DEPEND_CACHE_TIME) &&
+	    !fed_mgr_fed_rec) {
+		job_ptr->bit_flags |= JOB_DEPENDENT;
+		acct_policy_remove_accrue_time(job_ptr, false);
+		if (was_changed)
+			*was_changed = changed;
+		return LOCAL_DEPEND;
+	}
+
 	depend_iter = list_iterator_create(job_ptr->details->depend_list);
 	while ((dep_ptr = list_next(depend_iter))) {
 		bool clear_dep = false, failure = false;
@@ -3105,7 +3231,8 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 			log_flag(DEPENDENCY, "%s: %pJ dependency %s:%u fulfilled.",
 				 __func__, job_ptr, _depend_type2str(dep_ptr),
 				 dep_ptr->job_id);
-		}
+		} else if (!_depend_event_driven(dep_ptr))
+			event_driven = false;
 
 		_test_dependency_state(dep_ptr, &or_satisfied, &and_failed,
 				       &or_flag, &has_unfulfilled);
@@ -3151,6 +3278,11 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 				REMOTE_DEPEND;
 	}
 
+	if ((results == LOCAL_DEPEND) && event_driven)
+		_cache_depend_result(job_ptr);
+	else
+		job_ptr->details->depend_test_time = 0;
+
 	if (was_changed)
 		*was_changed = changed;
 	return results;
@@ -3762,6 +3894,10 @@ extern int update_job_dependency(job_record_t *job_ptr, char *new_depend)
 	if (job_ptr->details == NULL)
 		return EINVAL;
 
+	/* Registrations on the old jobs depended upon become stale */
+	job_ptr->details->depend_reg_job_id = 0;
+	job_ptr->details->depend_test_time = 0;
+
 	if (select_hetero == -1) {
 		/*
 		 * Determine if the select plugin supports heterogeneous
@@ -5088,6 +5224,7 @@ void cleanup_completing(job_record_t *job_ptr)
 
 	delete_step_records(job_ptr);
 	job_ptr->job_state &= (~JOB_COMPLETING);
+	retest_job_dependents(job_ptr);
 	job_hold_requeue(job_ptr);
 
 	/*
@@ -245,6 +245,13 @@ extern int sort_job_queue2(void *x, void *y);
  */
 extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed);
 
+/*
+ * Invalidate the cached dependency test of every job waiting on a state
+ * change of job_ptr, its job array or its heterogeneous job. Call whenever
+ * job_ptr starts or completes.
+ */
+extern void retest_job_dependents(job_record_t *job_ptr);
+
 /*
  * Parse a job dependency string and use it to establish a "depend_spec"
  * list of dependencies. We accept both old format (a single job ID) and
@@ -58,10 +58,23 @@
 List license_list = (List) NULL;
 time_t last_license_update = 0;
 static pthread_mutex_t license_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Every license name ever configured is interned to a stable id, the index
+ * in license_names. license_index maps those ids to the license_list records
+ * so the license records of a job are found without name comparisons.
+ */
+static pthread_mutex_t license_id_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char **license_names = NULL;
+static uint32_t license_name_cnt = 0;
+static licenses_t **license_index = NULL;	/* protected by license_mutex */
+static uint32_t license_index_cnt = 0;
+
 static void _pack_license(licenses_t *lic, buf_t *buffer,
 			  uint16_t protocol_version);
 
 typedef struct {
+	uint32_t id;
 	char *name;
 	slurmctld_resv_t *resv_ptr;
 } bf_licenses_find_resv_t;
@@ -103,6 +116,69 @@ extern void license_free_rec(void *x)
 	}
 }
 
+/*
+ * Return the id of a license name, NO_VAL if the name was never configured.
+ * IN add - intern the name if not yet known
+ */
+static uint32_t _license_name_id(char *name, bool add)
+{
+	uint32_t id;
+
+	slurm_mutex_lock(&license_id_mutex);
+	for (id = 0; id < license_name_cnt; id++) {
+		if (!xstrcmp(license_names[id], name))
+			break;
+	}
+	if (id == license_name_cnt) {
+		if (add) {
+			xrecalloc(license_names, license_name_cnt + 1,
+				  sizeof(char *));
+			license_names[license_name_cnt++] = xstrdup(name);
+		} else
+			id = NO_VAL;
+	}
+	slurm_mutex_unlock(&license_id_mutex);
+
+	return id;
+}
+
+/*
+ * Rebuild license_index after license_list records were added or removed.
+ * license_mutex should be locked before calling this.
+ */
+static void _license_index_rebuild(void)
+{
+	ListIterator iter;
+	licenses_t *license_entry;
+
+	slurm_mutex_lock(&license_id_mutex);
+	license_index_cnt = license_name_cnt;
+	slurm_mutex_unlock(&license_id_mutex);
+
+	xfree(license_index);
+	if (!license_index_cnt)
+		return;
+	license_index = xcalloc(license_index_cnt, sizeof(licenses_t *));
+
+	if (!license_list)
+		return;
+	iter = list_iterator_create(license_list);
+	while ((license_entry = list_next(iter))) {
+		if (license_entry->id < license_index_cnt)
+			license_index[license_entry->id] = license_entry;
+	}
+	list_iterator_destroy(iter);
+}
+
+/* Return true if both records describe the same license */
+static bool _license_match(uint32_t id_1, char *name_1,
+			   uint32_t id_2, char *name_2)
+{
+	if ((id_1 != NO_VAL) && (id_2 != NO_VAL))
+		return (id_1 == id_2);
+	return !xstrcmp(name_1, name_2);
+}
+
 /* Find a license_t record by license name (for use by list_find_first) */
 static int _license_find_rec(void *x, void *key)
 {
@@ -126,6 +202,22 @@ static int _license_find_remote_rec(void *x, void *key)
 	return _license_find_rec(x, key);
 }
 
+/*
+ * Find the license_list record matching a job's license record.
+ * license_mutex should be locked before calling this.
+ */
+static licenses_t *_license_find(licenses_t *license_entry)
+{
+	if (license_entry->id < license_index_cnt)
+		return license_index[license_entry->id];
+	if ((license_entry->id != NO_VAL) || !license_list)
+		return NULL;	/* interned after the last index rebuild */
+
+	/* Name unknown when the job's licenses were parsed */
+	return list_find_first(license_list, _license_find_rec,
+			       license_entry->name);
+}
+
 /* Given a license string, return a list of license_t records */
 static List _build_license_list(char *licenses, bool *valid)
 {
@@ -168,6 +260,7 @@ static List _build_license_list(char *licenses, bool *valid)
 			license_entry->total += num;
 		} else {
 			license_entry = xmalloc(sizeof(licenses_t));
+			license_entry->id = _license_name_id(token, false);
 			license_entry->name = xstrdup(token);
 			license_entry->total = num;
 			list_push(lic_list, license_entry);
@@ -218,14 +311,31 @@ static void _add_res_rec_2_lic_list(slurmdb_res_rec_t *rec, bool sync)
 	licenses_t *license_entry = xmalloc(sizeof(licenses_t));
 
 	license_entry->name = xstrdup_printf("%s@%s", rec->name, rec->server);
+	license_entry->id = _license_name_id(license_entry->name, true);
 	license_entry->total = ((rec->count *
 				 rec->clus_res_rec->percent_allowed) / 100);
 	license_entry->remote = sync ? 2 : 1;
 
 	list_push(license_list, license_entry);
+	_license_index_rebuild();
 	last_license_update = time(NULL);
 }
 
+/* Intern the names of configured licenses */
+static void _intern_license_list(List lic_list)
+{
+	ListIterator iter;
+	licenses_t *license_entry;
+
+	if (!lic_list)
+		return;
+
+	iter = list_iterator_create(lic_list);
+	while ((license_entry = list_next(iter)))
+		license_entry->id = _license_name_id(license_entry->name, true);
+	list_iterator_destroy(iter);
+}
+
 /* Initialize licenses on this system based upon slurm.conf */
 extern int license_init(char *licenses)
 {
@@ -240,6 +350,8 @@ extern int license_init(char *licenses)
 	license_list = _build_license_list(licenses, &valid);
 	if (!valid)
 		fatal("Invalid configured licenses: %s", licenses);
+	_intern_license_list(license_list);
+	_license_index_rebuild();
 
 	_licenses_print("init_license", license_list, NULL);
 	slurm_mutex_unlock(&license_mutex);
@@ -258,10 +370,12 @@ extern int license_update(char *licenses)
         new_list = _build_license_list(licenses, &valid);
         if (!valid)
                 fatal("Invalid configured licenses: %s", licenses);
+	_intern_license_list(new_list);
 
         slurm_mutex_lock(&license_mutex);
         if (!license_list) {        /* no licenses before now */
                 license_list = new_list;
+		_license_index_rebuild();
                 slurm_mutex_unlock(&license_mutex);
                 return SLURM_SUCCESS;
         }
@@ -298,6 +412,7 @@ extern int license_update(char *licenses)
 
         FREE_NULL_LIST(license_list);
         license_list = new_list;
+	_license_index_rebuild();
         _licenses_print("update_license", license_list, NULL);
         slurm_mutex_unlock(&license_mutex);
         return SLURM_SUCCESS;
@@ -407,6 +522,7 @@ extern void license_remove_remote(slurmdb_res_rec_t *rec)
 			     "removed with %u in use",
 			     license_entry->name, license_entry->used);
 			list_delete_item(iter);
+			_license_index_rebuild();
 			last_license_update = time(NULL);
 			break;
 		}
@@ -480,6 +596,7 @@ extern void license_sync_remote(List res_list)
 			license_entry->remote = 1;
 	}
 	list_iterator_destroy(iter);
+	_license_index_rebuild();
 
 	slurm_mutex_unlock(&license_mutex);
 }
@@ -489,7 +606,16 @@ extern void license_free(void)
 {
 	slurm_mutex_lock(&license_mutex);
 	FREE_NULL_LIST(license_list);
+	xfree(license_index);
+	license_index_cnt = 0;
 	slurm_mutex_unlock(&license_mutex);
+
+	slurm_mutex_lock(&license_id_mutex);
+	for (int i = 0; i < license_name_cnt; i++)
+		xfree(license_names[i]);
+	xfree(license_names);
+	license_name_cnt = 0;
+	slurm_mutex_unlock(&license_id_mutex);
 }
 
 /*
@@ -547,7 +673,9 @@ extern List license_validate(char *licenses, bool validate_configured,
 			}
 			*valid = false;
 			break;
-		} else if (validate_configured &&
+		}
+		license_entry->id = match->id;
+		if (validate_configured &&
 			   (license_entry->total > match->total)) {
 			debug("Licenses count requested higher than configured "
 			      "(%s: %u > %u)",
@@ -608,8 +736,7 @@ extern int license_job_test(job_record_t *job_ptr, time_t when, bool reboot)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry);
 		if (!match) {
 			error("could not find license %s for job %u",
 			      license_entry->name, job_ptr->job_id);
@@ -660,6 +787,7 @@ extern List license_copy(List license_list_src)
 	iter = list_iterator_create(license_list_src);
 	while ((license_entry_src = list_next(iter))) {
 		license_entry_dest = xmalloc(sizeof(licenses_t));
+		license_entry_dest->id = license_entry_src->id;
 		license_entry_dest->name = xstrdup(license_entry_src->name);
 		license_entry_dest->total = license_entry_src->total;
 		list_push(license_list_dest, license_entry_dest);
@@ -687,8 +815,7 @@ extern int license_job_get(job_record_t *job_ptr)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry);
 		if (match) {
 			match->used += license_entry->total;
 			license_entry->used += license_entry->total;
@@ -723,8 +850,7 @@ extern int license_job_return(job_record_t *job_ptr)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry);
 		if (match) {
 			if (match->used >= license_entry->total)
 				match->used -= license_entry->total;
@@ -962,37 +1088,37 @@ static void _bf_license_free_rec(void *x)
 }
 
 /*
- * Will never match on a reserved license.
+ * Find a license in a reservation, or the global license if resv_ptr is NULL.
  */
-static int _bf_licenses_find_rec(void *x, void *key)
+static int _bf_licenses_find_resv(void *x, void *key)
 {
 	bf_license_t *license_entry = x;
-	char *name = key;
+	bf_licenses_find_resv_t *target = key;
 
 	xassert(license_entry->name);
-	xassert(name);
+	xassert(target->name);
 
-	if (license_entry->resv_ptr)
+	if (license_entry->resv_ptr != target->resv_ptr)
 		return 0;
 
-	if (!xstrcmp(license_entry->name, name))
-		return 1;
+	if (!_license_match(license_entry->id, license_entry->name,
+			    target->id, target->name))
+		return 0;
 
-	return 0;
+	return 1;
 }
 
-static int _bf_licenses_find_resv(void *x, void *key)
+/* Find the global (not reserved) backfill record of a license */
+static bf_license_t *_bf_licenses_find_global(bf_licenses_t *licenses,
+					      uint32_t id, char *name)
 {
-	bf_license_t *license_entry = x;
-	bf_licenses_find_resv_t *target = key;
-
-	if (license_entry->resv_ptr != target->resv_ptr)
-		return 0;
-
-	if (xstrcmp(license_entry->name, target->name))
-		return 0;
+	bf_licenses_find_resv_t target_record = {
+		.id = id,
+		.name = name,
+	};
 
-	return 1;
+	return list_find_first(licenses, _bf_licenses_find_resv,
+			       &target_record);
 }
 
 extern List bf_licenses_initial(bool bf_running_job_reserve)
@@ -1010,6 +1136,7 @@ extern List bf_licenses_initial(bool bf_running_job_reserve)
 	iter = list_iterator_create(license_list);
 	while ((license_entry = list_next(iter))) {
 		bf_entry = xmalloc(sizeof(*bf_entry));
+		bf_entry->id = license_entry->id;
 		bf_entry->name = xstrdup(license_entry->name);
 		bf_entry->remaining = license_entry->total;
 
@@ -1061,6 +1188,7 @@ extern bf_licenses_t *slurm_bf_licenses_copy(bf_licenses_t *licenses_src)
 	iter = list_iterator_create(licenses_src);
 	while ((entry_src = list_next(iter))) {
 		entry_dest = xmalloc(sizeof(*entry_dest));
+		entry_dest->id = entry_src->id;
 		entry_dest->name = xstrdup(entry_src->name);
 		entry_dest->remaining = entry_src->remaining;
 		entry_dest->resv_ptr = entry_src->resv_ptr;
@@ -1094,6 +1222,7 @@ extern void slurm_bf_licenses_deduct(bf_licenses_t *licenses,
 		 */
 		if (job_ptr->resv_ptr) {
 			bf_licenses_find_resv_t target_record = {
+				.id = job_entry->id,
 				.name = job_entry->name,
 				.resv_ptr = job_ptr->resv_ptr,
 			};
@@ -1110,8 +1239,8 @@ extern void slurm_bf_licenses_deduct(bf_licenses_t *licenses,
 			}
 		}
 
-		bf_entry = list_find_first(licenses, _bf_licenses_find_rec,
-					   job_entry->name);
+		bf_entry = _bf_licenses_find_global(licenses, job_entry->id,
+						    job_entry->name);
 
 		if (bf_entry->remaining < needed) {
 			error("%s: underflow on %s", __func__, bf_entry->name);
@@ -1144,8 +1273,8 @@ extern void slurm_bf_licenses_transfer(bf_licenses_t *licenses,
 		bf_license_t *bf_entry, *new_entry;
 		int needed = resv_entry->total, reservable;
 
-		bf_entry = list_find_first(licenses, _bf_licenses_find_rec,
-					   resv_entry->name);
+		bf_entry = _bf_licenses_find_global(licenses, resv_entry->id,
+						    resv_entry->name);
 
 		if (bf_entry->remaining < needed) {
 			error("%s: underflow on %s", __func__, bf_entry->name);
@@ -1157,6 +1286,7 @@ extern void slurm_bf_licenses_transfer(bf_licenses_t *licenses,
 		}
 
 		new_entry = xmalloc(sizeof(*new_entry));
+		new_entry->id = resv_entry->id;
 		new_entry->name = xstrdup(resv_entry->name);
 		new_entry->remaining = reservable;
 		new_entry->resv_ptr = job_ptr->resv_ptr;
@@ -1188,6 +1318,7 @@ extern bool slurm_bf_licenses_avail(bf_licenses_t *licenses,
 		 */
 		if (job_ptr->resv_ptr) {
 			bf_licenses_find_resv_t target_record = {
+				.id = need->id,
 				.name = need->name,
 				.resv_ptr = job_ptr->resv_ptr,
 			};
@@ -1202,8 +1333,8 @@ extern bool slurm_bf_licenses_avail(bf_licenses_t *licenses,
 				needed -= resv_entry->remaining;
 		}
 
-		bf_entry = list_find_first(licenses, _bf_licenses_find_rec,
-					   need->name);
+		bf_entry = _bf_licenses_find_global(licenses, need->id,
+						    need->name);
 
 		if (bf_entry->remaining < needed) {
 			avail = false;
@@ -1223,8 +1354,8 @@ extern bool slurm_bf_licenses_equal(bf_licenses_t *a, bf_licenses_t *b)
 
 	iter = list_iterator_create(a);
 	while ((entry_a = list_next(iter))) {
-		entry_b = list_find_first(b, _bf_licenses_find_rec,
-					  entry_a->name);
+		entry_b = _bf_licenses_find_global(b, entry_a->id,
+						   entry_a->name);
 
 		if ((entry_a->remaining != entry_b->remaining) ||
 		    (entry_a->resv_ptr != entry_b->resv_ptr)) {
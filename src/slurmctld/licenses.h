@@ -43,6 +43,7 @@
 #include "src/slurmctld/slurmctld.h"
 
 typedef struct {
+	uint32_t	id;		/* interned name, NO_VAL if unknown */
 	char *		name;		/* name associated with a license */
 	uint32_t	total;		/* total license configued */
 	uint32_t	used;		/* used licenses */
@@ -56,6 +57,7 @@ typedef struct {
 typedef struct xlist bf_licenses_t;
 
 typedef struct {
+	uint32_t id;
 	char *name;
 	uint32_t remaining;
 	slurmctld_resv_t *resv_ptr;
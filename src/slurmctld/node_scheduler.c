@@ -2706,6 +2706,8 @@ extern int select_nodes(job_record_t *job_ptr, bool test_only,
 
 	job_ptr->job_state = JOB_RUNNING;
 	job_ptr->bit_flags |= JOB_WAS_RUNNING;
+	slurm_preempt_job_started(job_ptr);
+	retest_job_dependents(job_ptr);
 
 	if (select_g_select_nodeinfo_set(job_ptr) != SLURM_SUCCESS) {
 		error("select_g_select_nodeinfo_set(%pJ): %m", job_ptr);
@@ -92,6 +92,7 @@ char *exc_nodes = NULL, *exc_parts = NULL;
 time_t last_log = (time_t) 0, last_work_scan = (time_t) 0;
 uint16_t slurmd_timeout;
 static bool idle_on_node_suspend = false;
+static bool resume_ahead = false;
 static uint16_t power_save_interval = 10;
 static uint16_t power_save_min_interval = 0;
 
@@ -102,6 +103,12 @@ typedef struct exc_node_partital {
 	int exc_node_cnt;
 	bitstr_t *exc_node_cnt_bitmap;
 } exc_node_partital_t;
+
+typedef struct {
+	bitstr_t *ahead_bitmap;	/* nodes to resume ahead of a job start */
+	time_t now;
+} resume_ahead_arg_t;
+
 List partial_node_list;
 
 bitstr_t *exc_node_bitmap = NULL;
@@ -243,6 +250,35 @@ static int _pick_exc_nodes(void *x, void *arg)
 	return 0;
 }
 
+/*
+ * Identify powered down nodes which backfill has planned for a pending job
+ * expected to start within the node's ResumeTimeout. Resuming them now means
+ * the job does not have to wait for the nodes to boot once it is allocated.
+ * Locks: Read jobs and nodes
+ */
+static int _pick_resume_ahead(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+	resume_ahead_arg_t *ahead_arg = arg;
+	bitstr_t *sched_bitmap = NULL;
+	node_record_t *node_ptr;
+	time_t now = ahead_arg->now;
+
+	if (!IS_JOB_PENDING(job_ptr) || !job_ptr->sched_nodes ||
+	    (job_ptr->start_time <= now))
+		return 0;
+
+	(void) node_name2bitmap(job_ptr->sched_nodes, false, &sched_bitmap);
+	bit_and(sched_bitmap, power_node_bitmap);
+	for (int i = 0; (node_ptr = next_node_bitmap(sched_bitmap, &i)); i++) {
+		if (job_ptr->start_time <= (now + node_ptr->resume_timeout))
+			bit_set(ahead_arg->ahead_bitmap, i);
+	}
+	FREE_NULL_BITMAP(sched_bitmap);
+
+	return 0;
+}
+
 /* Perform any power change work to nodes */
 static void _do_power_work(time_t now)
 {
@@ -255,7 +291,7 @@ static void _do_power_work(time_t now)
 	data_t *resume_json_data = NULL;
 	data_t *jobs_data = NULL;
 	ListIterator iter;
-	bitstr_t *job_power_node_bitmap;
+	bitstr_t *job_power_node_bitmap, *ahead_node_bitmap = NULL;
 	uint32_t *job_id_ptr;
 	bool nodes_updated = false;
 
@@ -404,6 +440,16 @@ static void _do_power_work(time_t now)
 		FREE_NULL_BITMAP(to_resume_bitmap);
 	}
 
+	if (resume_ahead && bit_set_count(power_node_bitmap)) {
+		resume_ahead_arg_t ahead_arg = {
+			.ahead_bitmap = bit_alloc(node_record_count),
+			.now = now,
+		};
+
+		list_for_each(job_list, _pick_resume_ahead, &ahead_arg);
+		ahead_node_bitmap = ahead_arg.ahead_bitmap;
+	}
+
 	/* Build bitmaps identifying each node which should change state */
 	for (i = 0; (node_ptr = next_node(&i)); i++) {
 		susp_state = IS_NODE_POWERED_DOWN(node_ptr);
@@ -416,7 +462,9 @@ static void _do_power_work(time_t now)
 		    (susp_state &&
 		    ((resume_rate == 0) || (resume_cnt < resume_rate))	&&
 		    !IS_NODE_POWERING_DOWN(node_ptr) &&
-		    IS_NODE_POWER_UP(node_ptr))) {
+		    (IS_NODE_POWER_UP(node_ptr) ||
+		     (ahead_node_bitmap &&
+		      bit_test(ahead_node_bitmap, node_ptr->index))))) {
 			if (wake_node_bitmap == NULL) {
 				wake_node_bitmap =
 					bit_alloc(node_record_count);
@@ -565,6 +613,7 @@ static void _do_power_work(time_t now)
 		}
 	}
 	FREE_NULL_BITMAP(avoid_node_bitmap);
+	FREE_NULL_BITMAP(ahead_node_bitmap);
 	if (power_save_debug && ((now - last_log) > 600) && (susp_total > 0)) {
 		log_flag(POWER, "Power save mode: %d nodes", susp_total);
 		last_log = now;
@@ -752,6 +801,8 @@ static int _init_power_config(void)
 				      "cloud_reg_addrs");
 	idle_on_node_suspend = xstrcasestr(slurm_conf.slurmctld_params,
 					   "idle_on_node_suspend");
+	resume_ahead = xstrcasestr(slurm_conf.slurmctld_params,
+				   "power_save_resume_ahead");
 	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
 				   "power_save_interval="))) {
 		power_save_interval =
@@ -84,6 +84,19 @@ static plugin_context_t *g_context = NULL;
 static pthread_mutex_t	    g_context_lock = PTHREAD_MUTEX_INITIALIZER;
 static bool init_run = false;
 
+/*
+ * Job ids of running and suspended jobs, the only possible preemptees.
+ * run_job_ids is sorted and free of duplicates, started_job_ids holds the
+ * jobs started since it was last merged into run_job_ids. Jobs which are no
+ * longer running are dropped the next time the index is walked.
+ */
+static uint32_t *run_job_ids = NULL;
+static int run_job_cnt = 0;
+static bool run_job_ids_built = false;
+static uint32_t *started_job_ids = NULL;
+static int started_job_cnt = 0, started_job_size = 0;
+static pthread_mutex_t run_job_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static int _is_job_preempt_exempt_internal(void *x, void *key)
 {
 	job_record_t *preemptee_ptr = (job_record_t *)x;
@@ -186,6 +199,112 @@ static int _add_preemptable_job(void *x, void *arg)
 	return 0;
 }
 
+static int _cmp_job_id(const void *x, const void *y)
+{
+	uint32_t id1 = *(uint32_t *) x;
+	uint32_t id2 = *(uint32_t *) y;
+
+	if (id1 < id2)
+		return -1;
+	if (id1 > id2)
+		return 1;
+	return 0;
+}
+
+/*
+ * Merge started_job_ids into run_job_ids, dropping duplicates and jobs
+ * which are no longer running or suspended.
+ * NOTE: Caller must hold run_job_lock.
+ */
+static void _merge_run_job_ids(void)
+{
+	uint32_t *merged;
+	int i = 0, j = 0, cnt = 0;
+
+	if (!started_job_cnt)
+		return;
+
+	qsort(started_job_ids, started_job_cnt, sizeof(uint32_t),
+	      _cmp_job_id);
+	merged = xcalloc(run_job_cnt + started_job_cnt, sizeof(uint32_t));
+	while ((i < run_job_cnt) || (j < started_job_cnt)) {
+		uint32_t job_id;
+		job_record_t *job_ptr;
+
+		if ((j >= started_job_cnt) ||
+		    ((i < run_job_cnt) &&
+		     (run_job_ids[i] <= started_job_ids[j])))
+			job_id = run_job_ids[i++];
+		else
+			job_id = started_job_ids[j++];
+
+		if (cnt && (merged[cnt - 1] == job_id))
+			continue;
+		if (!(job_ptr = find_job_record(job_id)) ||
+		    (!IS_JOB_RUNNING(job_ptr) && !IS_JOB_SUSPENDED(job_ptr)))
+			continue;
+		merged[cnt++] = job_id;
+	}
+
+	xfree(run_job_ids);
+	run_job_ids = merged;
+	run_job_cnt = cnt;
+	started_job_cnt = 0;
+}
+
+/* NOTE: Caller must hold run_job_lock. */
+static void _add_started_job_id(uint32_t job_id)
+{
+	if (started_job_cnt >= started_job_size) {
+		/* Bound the backlog when nothing looks for preemptees */
+		if (started_job_cnt > MAX(run_job_cnt, 1024)) {
+			_merge_run_job_ids();
+		} else {
+			started_job_size = MAX(started_job_size * 2, 1024);
+			xrecalloc(started_job_ids, started_job_size,
+				  sizeof(uint32_t));
+		}
+	}
+	started_job_ids[started_job_cnt++] = job_id;
+}
+
+static int _add_run_job_id(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+
+	if (IS_JOB_RUNNING(job_ptr) || IS_JOB_SUSPENDED(job_ptr))
+		_add_started_job_id(job_ptr->job_id);
+
+	return 0;
+}
+
+/*
+ * Run _add_preemptable_job() on every running or suspended job, compacting
+ * out jobs that ended since the last call.
+ * NOTE: Caller must hold run_job_lock.
+ */
+static void _for_each_run_job(preempt_candidates_t *candidates)
+{
+	int i, cnt = 0;
+
+	if (!run_job_ids_built) {
+		list_for_each(job_list, _add_run_job_id, NULL);
+		run_job_ids_built = true;
+	}
+	_merge_run_job_ids();
+
+	for (i = 0; i < run_job_cnt; i++) {
+		job_record_t *job_ptr = find_job_record(run_job_ids[i]);
+
+		if (!job_ptr ||
+		    (!IS_JOB_RUNNING(job_ptr) && !IS_JOB_SUSPENDED(job_ptr)))
+			continue;
+		run_job_ids[cnt++] = run_job_ids[i];
+		(void) _add_preemptable_job(job_ptr, candidates);
+	}
+	run_job_cnt = cnt;
+}
+
 static int _sort_by_prio(void *x, void *y)
 {
 	int rc;
@@ -274,9 +393,26 @@ extern int slurm_preempt_fini(void)
 	init_run = false;
 	rc = plugin_context_destroy(g_context);
 	g_context = NULL;
+
+	/* Rebuilt from job_list on next use */
+	slurm_mutex_lock(&run_job_lock);
+	xfree(run_job_ids);
+	run_job_cnt = 0;
+	xfree(started_job_ids);
+	started_job_cnt = started_job_size = 0;
+	run_job_ids_built = false;
+	slurm_mutex_unlock(&run_job_lock);
+
 	return rc;
 }
 
+extern void slurm_preempt_job_started(job_record_t *job_ptr)
+{
+	slurm_mutex_lock(&run_job_lock);
+	_add_started_job_id(job_ptr->job_id);
+	slurm_mutex_unlock(&run_job_lock);
+}
+
 extern List slurm_find_preemptable_jobs(job_record_t *job_ptr)
 {
 	preempt_candidates_t candidates	= { .preemptor = job_ptr };
@@ -302,8 +438,11 @@ extern List slurm_find_preemptable_jobs(job_record_t *job_ptr)
 
 	/* Build an array of pointers to preemption candidates */
 	if (slurm_preemption_enabled() ||
-	    job_uses_max_start_delay_resv(job_ptr))
-		list_for_each(job_list, _add_preemptable_job, &candidates);
+	    job_uses_max_start_delay_resv(job_ptr)) {
+		slurm_mutex_lock(&run_job_lock);
+		_for_each_run_job(&candidates);
+		slurm_mutex_unlock(&run_job_lock);
+	}
 
 	if (candidates.preemptee_job_list && youngest_order)
 		list_sort(candidates.preemptee_job_list, _sort_by_youngest);
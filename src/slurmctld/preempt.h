@@ -74,6 +74,12 @@ extern int slurm_preempt_fini(void);
  */
 extern List slurm_find_preemptable_jobs(job_record_t *job_ptr);
 
+/*
+ * Note that a job has started running so slurm_find_preemptable_jobs() will
+ * consider it. Jobs which stop running are forgotten automatically.
+ */
+extern void slurm_preempt_job_started(job_record_t *job_ptr);
+
 /*
  * Return the PreemptMode which should apply to stop this job
  */
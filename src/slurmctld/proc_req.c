@@ -136,6 +136,10 @@ static config_response_msg_t *config_for_clients = NULL;
 static pthread_mutex_t throttle_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t throttle_cond = PTHREAD_COND_INITIALIZER;
 
+static pthread_mutex_t prolog_comp_mutex = PTHREAD_MUTEX_INITIALIZER;
+static List prolog_comp_list = NULL;
+static bool prolog_comp_active = false;
+
 static void         _create_het_job_id_set(hostset_t jobid_hostset,
 					    uint32_t het_job_offset,
 					    char **het_job_id_set);
@@ -2162,14 +2166,43 @@ static void _slurm_rpc_complete_job_allocation(slurm_msg_t * msg)
 	log_flag(TRACE_JOBS, "%s: return %pJ", __func__, job_ptr);
 }
 
+/*
+ * Apply all queued prolog completions.
+ * Caller must hold the job write lock.
+ */
+static void _apply_prolog_completions(void)
+{
+	complete_prolog_msg_t *comp_msg;
+	int error_code;
+
+	slurm_mutex_lock(&prolog_comp_mutex);
+	while ((comp_msg = list_pop(prolog_comp_list))) {
+		slurm_mutex_unlock(&prolog_comp_mutex);
+
+		error_code = prolog_complete(comp_msg->job_id,
+					     comp_msg->prolog_rc,
+					     comp_msg->node_name);
+		if (error_code)
+			info("_slurm_rpc_complete_prolog JobId=%u: %s ",
+			     comp_msg->job_id, slurm_strerror(error_code));
+		slurm_free_complete_prolog_msg(comp_msg);
+
+		slurm_mutex_lock(&prolog_comp_mutex);
+	}
+	prolog_comp_active = false;
+	slurm_mutex_unlock(&prolog_comp_mutex);
+}
+
 /* _slurm_rpc_complete_prolog - process RPC to note the
  *	completion of a prolog */
 static void _slurm_rpc_complete_prolog(slurm_msg_t * msg)
 {
 	int error_code = SLURM_SUCCESS;
+	bool apply = false;
 	DEF_TIMERS;
 	complete_prolog_msg_t *comp_msg =
 		(complete_prolog_msg_t *) msg->data;
+	uint32_t job_id = comp_msg->job_id;
 	/* Locks: Write job, write node */
 	slurmctld_lock_t job_write_lock = {
 		NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
@@ -2177,25 +2210,48 @@ static void _slurm_rpc_complete_prolog(slurm_msg_t * msg)
 	/* init */
 	START_TIMER;
 	debug3("Processing RPC details: REQUEST_COMPLETE_PROLOG from JobId=%u",
-	       comp_msg->job_id);
+	       job_id);
 
-	if (!(msg->flags & CTLD_QUEUE_PROCESSING))
-		lock_slurmctld(job_write_lock);
-	error_code = prolog_complete(comp_msg->job_id, comp_msg->prolog_rc,
-				     comp_msg->node_name);
-	if (!(msg->flags & CTLD_QUEUE_PROCESSING))
-		unlock_slurmctld(job_write_lock);
+	if (msg->flags & CTLD_QUEUE_PROCESSING) {
+		error_code = prolog_complete(comp_msg->job_id,
+					     comp_msg->prolog_rc,
+					     comp_msg->node_name);
+	} else {
+		/*
+		 * All nodes of a large allocation finish their prolog at
+		 * about the same time. Queue the completion, and let a single
+		 * thread at a time take the job write lock and apply every
+		 * completion queued so far instead of each RPC taking the
+		 * lock in turn. Errors are logged when applied, slurmd does
+		 * not act on the return code.
+		 */
+		slurm_mutex_lock(&prolog_comp_mutex);
+		if (!prolog_comp_list)
+			prolog_comp_list = list_create((ListDelF)
+				slurm_free_complete_prolog_msg);
+		list_append(prolog_comp_list, comp_msg);
+		msg->data = NULL;
+		if (!prolog_comp_active)
+			apply = prolog_comp_active = true;
+		slurm_mutex_unlock(&prolog_comp_mutex);
+
+		if (apply) {
+			lock_slurmctld(job_write_lock);
+			_apply_prolog_completions();
+			unlock_slurmctld(job_write_lock);
+		}
+	}
 
 	END_TIMER2("_slurm_rpc_complete_prolog");
 
 	/* return result */
 	if (error_code) {
 		info("_slurm_rpc_complete_prolog JobId=%u: %s ",
-		     comp_msg->job_id, slurm_strerror(error_code));
+		     job_id, slurm_strerror(error_code));
 		slurm_send_rc_msg(msg, error_code);
 	} else {
 		debug2("_slurm_rpc_complete_prolog JobId=%u %s",
-		       comp_msg->job_id, TIME_STR);
+		       job_id, TIME_STR);
 		slurm_send_rc_msg(msg, SLURM_SUCCESS);
 	}
 }
@@ -120,6 +120,30 @@ List      resv_list = (List) NULL;
 static List magnetic_resv_list = NULL;
 uint32_t  top_suffix = 0;
 
+/*
+ * Time index over resv_list used by job_test_resv() and find_resv_end().
+ * Built on demand and discarded whenever a reservation is added, removed or
+ * has its times changed. Offsets refer to the position in resv_list so that
+ * callers can still visit overlapping reservations in list order.
+ */
+typedef struct {
+	time_t time;
+	int inx;
+} resv_time_ent_t;
+
+typedef struct {
+	int cnt;			/* reservations indexed */
+	int size;			/* allocated array entries */
+	bool valid;
+	time_t max_boot_time;		/* largest boot_time of any entry */
+	slurmctld_resv_t **resv;	/* reservations in resv_list order */
+	resv_time_ent_t *by_start;	/* sorted by start time */
+	resv_time_ent_t *by_end;	/* sorted by end_time */
+	bitstr_t *cand_bitmap;		/* scratch, one bit per reservation */
+} resv_time_index_t;
+
+static resv_time_index_t resv_index;
+
 /*
  * the two following structs enable to build a
  * planning of a constraint evolution over time
@@ -195,6 +219,7 @@ static int  _post_resv_delete(slurmctld_resv_t *resv_ptr);
 static int  _post_resv_update(slurmctld_resv_t *resv_ptr,
 			      slurmctld_resv_t *old_resv_ptr);
 static int  _resize_resv(slurmctld_resv_t *resv_ptr, uint32_t node_cnt);
+static void _resv_index_invalidate(void);
 static void _restore_resv(slurmctld_resv_t *dest_resv,
 			  slurmctld_resv_t *src_resv);
 static bool _resv_overlap(resv_desc_msg_t *resv_desc_ptr,
@@ -275,6 +300,7 @@ static List _list_dup(List license_list)
 	iter = list_iterator_create(license_list);
 	while ((license_src = list_next(iter))) {
 		license_dest = xmalloc(sizeof(licenses_t));
+		license_dest->id = license_src->id;
 		license_dest->name = xstrdup(license_src->name);
 		license_dest->used = license_src->used;
 		list_push(lic_list, license_dest);
@@ -465,6 +491,8 @@ static void _del_resv_rec(void *x)
 	slurmctld_resv_t *resv_ptr = (slurmctld_resv_t *) x;
 
 	if (resv_ptr) {
+		_resv_index_invalidate();
+
 		/*
 		 * If shutting down magnetic_resv_list is already freed, meaning
 		 * we don't need to remove anything from it.
@@ -527,10 +555,139 @@ static void _add_resv_to_lists(slurmctld_resv_t *resv_ptr)
 	xassert(magnetic_resv_list);
 
 	list_append(resv_list, resv_ptr);
+	_resv_index_invalidate();
 	if (resv_ptr->flags & RESERVE_FLAG_MAGNETIC)
 		list_append(magnetic_resv_list, resv_ptr);
 }
 
+static void _resv_index_invalidate(void)
+{
+	resv_index.valid = false;
+}
+
+static void _resv_index_free(void)
+{
+	xfree(resv_index.resv);
+	xfree(resv_index.by_start);
+	xfree(resv_index.by_end);
+	FREE_NULL_BITMAP(resv_index.cand_bitmap);
+	memset(&resv_index, 0, sizeof(resv_index));
+}
+
+static int _cmp_resv_time_ent(const void *x, const void *y)
+{
+	const resv_time_ent_t *ent1 = x, *ent2 = y;
+
+	if (ent1->time < ent2->time)
+		return -1;
+	if (ent1->time > ent2->time)
+		return 1;
+	return ent1->inx - ent2->inx;
+}
+
+static int _resv_index_add(void *x, void *arg)
+{
+	slurmctld_resv_t *resv_ptr = x;
+	int inx = resv_index.cnt++;
+
+	resv_index.resv[inx] = resv_ptr;
+	resv_index.by_start[inx].inx = inx;
+	resv_index.by_end[inx].inx = inx;
+	/*
+	 * Floating reservations move with the current time, index them as
+	 * starting immediately so they are always checked.
+	 */
+	if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT)
+		resv_index.by_start[inx].time = 0;
+	else
+		resv_index.by_start[inx].time = resv_ptr->start_time_first;
+	resv_index.by_end[inx].time = resv_ptr->end_time;
+	resv_index.max_boot_time = MAX(resv_index.max_boot_time,
+				       resv_ptr->boot_time);
+
+	return 0;
+}
+
+/* Make sure resv_index describes the current contents of resv_list */
+static void _resv_index_build(void)
+{
+	int cnt;
+
+	/*
+	 * Callers such as sched/builtin only hold a node read lock, the job
+	 * write lock is what serializes rebuilding the index.
+	 */
+	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
+
+	if (resv_index.valid)
+		return;
+
+	cnt = resv_list ? list_count(resv_list) : 0;
+	if (cnt > resv_index.size) {
+		resv_index.size = cnt;
+		xrecalloc(resv_index.resv, cnt, sizeof(slurmctld_resv_t *));
+		xrecalloc(resv_index.by_start, cnt, sizeof(resv_time_ent_t));
+		xrecalloc(resv_index.by_end, cnt, sizeof(resv_time_ent_t));
+		FREE_NULL_BITMAP(resv_index.cand_bitmap);
+		resv_index.cand_bitmap = bit_alloc(cnt);
+	}
+	resv_index.cnt = 0;
+	resv_index.max_boot_time = 0;
+	if (cnt)
+		list_for_each(resv_list, _resv_index_add, NULL);
+	xassert(resv_index.cnt == cnt);
+
+	qsort(resv_index.by_start, cnt, sizeof(resv_time_ent_t),
+	      _cmp_resv_time_ent);
+	qsort(resv_index.by_end, cnt, sizeof(resv_time_ent_t),
+	      _cmp_resv_time_ent);
+	resv_index.valid = true;
+}
+
+/* Return offset of the first entry of ents with a time of at least when */
+static int _resv_index_lower_bound(resv_time_ent_t *ents, time_t when)
+{
+	int lo = 0, hi = resv_index.cnt;
+
+	while (lo < hi) {
+		int mid = lo + ((hi - lo) / 2);
+		if (ents[mid].time < when)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * Mark in resv_index.cand_bitmap every reservation which may start before
+ * end_time (plus its boot time if reboot is set). Callers must still apply
+ * the exact overlap test from _get_rel_start_end() to each marked entry.
+ * RET number of candidates marked
+ */
+static int _resv_index_candidates(time_t end_time, bool reboot)
+{
+	int i, cnt;
+
+	_resv_index_build();
+	if (!resv_index.cnt)
+		return 0;
+
+	if (reboot)
+		end_time += resv_index.max_boot_time;
+	cnt = _resv_index_lower_bound(resv_index.by_start, end_time);
+
+	bit_clear_all(resv_index.cand_bitmap);
+	if (cnt == resv_index.cnt) {
+		bit_nset(resv_index.cand_bitmap, 0, cnt - 1);
+	} else {
+		for (i = 0; i < cnt; i++)
+			bit_set(resv_index.cand_bitmap,
+				resv_index.by_start[i].inx);
+	}
+	return cnt;
+}
+
 static int _queue_magnetic_resv(void *x, void *key)
 {
 	slurmctld_resv_t *resv_ptr = (slurmctld_resv_t *) x;
@@ -2984,6 +3141,7 @@ extern void resv_fini(void)
 {
 	FREE_NULL_LIST(magnetic_resv_list);
 	FREE_NULL_LIST(resv_list);
+	_resv_index_free();
 }
 
 /* Update an exiting resource reservation */
@@ -6293,8 +6451,7 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 	time_t job_start_time, job_end_time, job_end_time_use, lic_resv_time;
 	time_t start_relative, end_relative;
 	time_t now = time(NULL);
-	ListIterator iter;
-	int i, rc = SLURM_SUCCESS, rc2;
+	int i, j, rc = SLURM_SUCCESS, rc2;
 
 	*resv_overlap = false;	/* initialize to false */
 	job_start_time = *when;
@@ -6376,8 +6533,11 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 		 * if there are any overlapping reservations, we need to
 		 * prevent the job from using those nodes (e.g. MAINT nodes)
 		 */
-		iter = list_iterator_create(resv_list);
-		while ((res2_ptr = list_next(iter))) {
+		(void) _resv_index_candidates(job_end_time, reboot);
+		for (j = 0;
+		     ((j = bit_ffs_from_bit(resv_index.cand_bitmap, j)) >= 0);
+		     j++) {
+			res2_ptr = resv_index.resv[j];
 			if (reboot)
 				job_end_time_use =
 					job_end_time + res2_ptr->boot_time;
@@ -6407,7 +6567,6 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 				bit_and_not(*node_bitmap,res2_ptr->node_bitmap);
 			}
 		}
-		list_iterator_destroy(iter);
 
 		if (slurm_conf.debug_flags & DEBUG_FLAG_RESERVATION) {
 			char *nodes = bitmap2node_name(*node_bitmap);
@@ -6441,8 +6600,11 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 	for (i = 0; ; i++) {
 		lic_resv_time = (time_t) 0;
 
-		iter = list_iterator_create(resv_list);
-		while ((resv_ptr = list_next(iter))) {
+		(void) _resv_index_candidates(job_end_time, reboot);
+		for (j = 0;
+		     ((j = bit_ffs_from_bit(resv_index.cand_bitmap, j)) >= 0);
+		     j++) {
+			resv_ptr = resv_index.resv[j];
 			_get_rel_start_end(
 				resv_ptr, now, &start_relative, &end_relative);
 
@@ -6532,7 +6694,6 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 				continue;
 			}
 		}
-		list_iterator_destroy(iter);
 
 		if ((rc == SLURM_SUCCESS) && move_time) {
 			if (license_job_test(job_ptr, job_start_time, reboot)
@@ -6623,21 +6784,16 @@ static int _update_resv_group_uid_access_list(void *x, void *arg)
  */
 extern time_t find_resv_end(time_t start_time, int resolution)
 {
-	ListIterator iter;
-	slurmctld_resv_t *resv_ptr;
 	time_t end_time = 0;
+	int inx;
 
 	if (!resv_list)
 		return end_time;
 
-	iter = list_iterator_create(resv_list);
-	while ((resv_ptr = list_next(iter))) {
-		if (start_time > resv_ptr->end_time)
-			continue;
-		if ((end_time == 0) || (resv_ptr->end_time < end_time))
-			end_time = resv_ptr->end_time;
-	}
-	list_iterator_destroy(iter);
+	_resv_index_build();
+	inx = _resv_index_lower_bound(resv_index.by_end, start_time);
+	if (inx < resv_index.cnt)
+		end_time = resv_index.by_end[inx].time;
 
 	/* Round-up returned time to given resolution */
 	if (resolution > 0) {
@@ -6806,6 +6962,7 @@ static int _advance_resv_time(slurmctld_resv_t *resv_ptr)
 		resv_ptr->start_time_prev = resv_ptr->start_time;
 		resv_ptr->start_time_first = resv_ptr->start_time;
 		_advance_time(&resv_ptr->end_time, day_cnt, hour_cnt);
+		_resv_index_invalidate();
 		resv_ptr->ctld_flags &= (~RESV_CTLD_PROLOG);
 		resv_ptr->ctld_flags &= (~RESV_CTLD_EPILOG);
 		_post_resv_create(resv_ptr);
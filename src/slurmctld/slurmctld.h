@@ -573,6 +573,12 @@ struct job_details {
 					 * scrontab) */
 	uint16_t orig_cpus_per_task;	/* requested value of cpus_per_task */
 	List depend_list;		/* list of job_ptr:state pairs */
+	uint32_t depend_reg_job_id;	/* job_id under which the job is in the
+					 * dependent_ids of the jobs it
+					 * depends upon, 0 if not registered */
+	time_t depend_test_time;	/* time of the last full dependency
+					 * test if its LOCAL_DEPEND result may
+					 * be reused, 0 otherwise */
 	char *dependency;		/* wait for other jobs */
 	char *orig_dependency;		/* original value (for archiving) */
 	uint16_t env_cnt;		/* size of env_sup (see below) */
@@ -756,6 +762,10 @@ struct job_record {
 	uint64_t db_index;              /* used only for database plugins */
 	time_t deadline;		/* deadline */
 	uint32_t delay_boot;		/* Delay boot for desired node mode */
+	uint32_t dependent_cnt;		/* count of dependent_ids */
+	uint32_t *dependent_ids;	/* jobs whose cached dependency test
+					 * waits on a state change of this
+					 * job, see retest_job_dependents() */
 	uint32_t derived_ec;		/* highest exit code of all job steps */
 	struct job_details *details;	/* job details */
 	uint16_t direct_set_prio;	/* Priority set directly if
@@ -299,23 +299,38 @@ static bool _msg_readable(eio_obj_t *obj)
 
 static int _write_msg(int fd, int req, buf_t *buffer)
 {
-	int len = 0;
+	int len = 0, hdr[2];
+	char *frame;
+	size_t frame_len;
 
-	slurm_mutex_lock(&write_mutex);
-	safe_write(fd, &req, sizeof(int));
-	if (buffer) {
+	/* A 0 length lets the receiver know not to read anymore */
+	if (buffer)
 		len = get_buf_offset(buffer);
-		safe_write(fd, &len, sizeof(int));
-		safe_write(fd, get_buf_data(buffer), len);
-	} else /* Write 0 length so the receiver knows not to read anymore */
-		safe_write(fd, &len, sizeof(int));
+
+	/*
+	 * Build the whole frame first so it goes out with a single write
+	 * rather than three, keeping write_mutex held for less time when
+	 * many scripts complete at once.
+	 */
+	hdr[0] = req;
+	hdr[1] = len;
+	frame_len = sizeof(hdr) + len;
+	frame = xmalloc_nz(frame_len);
+	memcpy(frame, hdr, sizeof(hdr));
+	if (len)
+		memcpy(frame + sizeof(hdr), get_buf_data(buffer), len);
+
+	slurm_mutex_lock(&write_mutex);
+	safe_write(fd, frame, frame_len);
 	slurm_mutex_unlock(&write_mutex);
+	xfree(frame);
 
 	return SLURM_SUCCESS;
 
 rwfail:
 	error("%s: read/write op failed", __func__);
 	slurm_mutex_unlock(&write_mutex);
+	xfree(frame);
 	return SLURM_ERROR;
 }
 
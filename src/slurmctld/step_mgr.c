@@ -908,42 +908,84 @@ static bitstr_t *_pick_step_nodes_cpus(job_record_t *job_ptr,
 	return NULL;
 }
 
-static int _mark_busy_nodes(void *x, void *arg)
+/*
+ * Return true if a job step is counted in job_resrcs->steps_used. The batch,
+ * extern and interactive steps are not considered when looking for "idle"
+ * nodes.
+ */
+static bool _step_counts_as_used(step_record_t *step_ptr)
 {
-	step_record_t *step_ptr = (step_record_t *) x;
-	bitstr_t *busy = (bitstr_t *) arg;
-
-	if (step_ptr->state < JOB_RUNNING)
-		return 0;
+	if (!step_ptr->step_layout || !step_ptr->step_node_bitmap)
+		return false;
 
-	/*
-	 * Don't consider the batch and extern steps when
-	 * looking for "idle" nodes.
-	 */
 	if ((step_ptr->step_id.step_id == SLURM_BATCH_SCRIPT) ||
 	    (step_ptr->step_id.step_id == SLURM_EXTERN_CONT) ||
-	    (step_ptr->step_id.step_id == SLURM_INTERACTIVE_STEP))
-		return 0;
+	    (step_ptr->step_id.step_id == SLURM_INTERACTIVE_STEP) ||
+	    (step_ptr->step_id.step_id == SLURM_PENDING_STEP))
+		return false;
 
-	if (!step_ptr->step_node_bitmap) {
-		error("%s: %pS has no step_node_bitmap",
-		      __func__, step_ptr);
-		return 0;
-	}
+	return true;
+}
 
-	bit_or(busy, step_ptr->step_node_bitmap);
+/*
+ * Add or remove a job step from the count of running steps on each of its
+ * nodes, if the job's index of running steps has been built.
+ */
+static void _step_update_steps_used(step_record_t *step_ptr, bool add)
+{
+	job_resources_t *job_resrcs_ptr = step_ptr->job_ptr->job_resrcs;
+	uint32_t *steps_used;
 
-	if (slurm_conf.debug_flags & DEBUG_FLAG_STEPS) {
-		char *temp;
-		temp = bitmap2node_name(step_ptr->step_node_bitmap);
-		log_flag(STEPS, "%s: %pS has nodes %s",
-			 __func__, step_ptr, temp);
-		xfree(temp);
+	if (!job_resrcs_ptr || !job_resrcs_ptr->steps_used ||
+	    !_step_counts_as_used(step_ptr))
+		return;
+
+	steps_used = job_resrcs_ptr->steps_used;
+	for (int i = 0, job_node_inx = 0;
+	     next_node_bitmap(job_resrcs_ptr->node_bitmap, &i);
+	     i++, job_node_inx++) {
+		if (!bit_test(step_ptr->step_node_bitmap, i))
+			continue;
+		if (add)
+			steps_used[job_node_inx]++;
+		else if (steps_used[job_node_inx])
+			steps_used[job_node_inx]--;
 	}
+}
+
+static int _add_steps_used(void *x, void *arg)
+{
+	step_record_t *step_ptr = (step_record_t *) x;
+
+	/* Completing steps have already released their resources */
+	if ((step_ptr->state < JOB_RUNNING) ||
+	    (step_ptr->state & JOB_COMPLETING))
+		return 0;
+
+	_step_update_steps_used(step_ptr, true);
 
 	return 0;
 }
 
+/*
+ * Return the count of running steps on each of a job's nodes. The index is
+ * built from the job's step list the first time it is needed (e.g. after
+ * slurmctld restart or job resize) and then updated as steps are allocated
+ * and deallocated, so picking idle nodes does not scan every running step.
+ */
+static uint32_t *_get_steps_used(job_record_t *job_ptr)
+{
+	job_resources_t *job_resrcs_ptr = job_ptr->job_resrcs;
+
+	if (!job_resrcs_ptr->steps_used) {
+		job_resrcs_ptr->steps_used = xcalloc(job_resrcs_ptr->nhosts,
+						     sizeof(uint32_t));
+		list_for_each(job_ptr->step_list, _add_steps_used, NULL);
+	}
+
+	return job_resrcs_ptr->steps_used;
+}
+
 /*
  * _pick_step_nodes - select nodes for a job step that satisfy its requirements
  *	we satisfy the super-set of constraints.
@@ -1447,10 +1489,16 @@ static bitstr_t *_pick_step_nodes(job_record_t *job_ptr,
 		bit_and_not(nodes_avail, relative_nodes);
 		FREE_NULL_BITMAP(relative_nodes);
 	} else {
-		nodes_idle = bit_alloc (bit_size (nodes_avail) );
-		list_for_each(job_ptr->step_list, _mark_busy_nodes, nodes_idle);
-		bit_not(nodes_idle);
-		bit_and(nodes_idle, nodes_avail);
+		uint32_t *steps_used = _get_steps_used(job_ptr);
+
+		nodes_idle = bit_alloc(bit_size(nodes_avail));
+		for (int i = 0, job_node_inx = 0;
+		     next_node_bitmap(job_resrcs_ptr->node_bitmap, &i);
+		     i++, job_node_inx++) {
+			if (!steps_used[job_node_inx] &&
+			    bit_test(nodes_avail, i))
+				bit_set(nodes_idle, i);
+		}
 	}
 
 	if (slurm_conf.debug_flags & DEBUG_FLAG_STEPS) {
@@ -2228,6 +2276,8 @@ static int _step_alloc_lps(step_record_t *step_ptr)
 	if (!bit_set_count(job_resrcs_ptr->node_bitmap))
 		return rc;
 
+	_step_update_steps_used(step_ptr, true);
+
 	if (step_ptr->threads_per_core &&
 	    (step_ptr->threads_per_core != NO_VAL16))
 		req_tpc = step_ptr->threads_per_core;
@@ -2579,6 +2629,8 @@ static void _step_dealloc_lps(step_record_t *step_ptr)
 	if (!bit_set_count(job_resrcs_ptr->node_bitmap))
 		return;
 
+	_step_update_steps_used(step_ptr, false);
+
 	if (step_ptr->memory_allocated && _is_mem_resv() &&
 	    ((job_resrcs_ptr->memory_allocated == NULL) ||
 	     (job_resrcs_ptr->memory_used == NULL))) {
@@ -5223,6 +5275,8 @@ extern void rebuild_step_bitmaps(job_record_t *job_ptr,
 
 	list_for_each(job_ptr->step_list, _rebuild_bitmaps,
 		      orig_job_node_bitmap);
+	/* Node indexes changed, rebuild the running steps index on demand */
+	xfree(job_ptr->job_resrcs->steps_used);
 
 }
 
@@ -273,6 +273,22 @@ static List bcast_libdir_list = NULL;
 
 static pthread_mutex_t waiter_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Recent REQUEST_JOB_STEP_STAT replies. Monitoring tools often poll the same
+ * steps with several sstat clients at once; answering from a sample taken in
+ * the last STEP_STAT_CACHE_TIME seconds spares slurmstepd from gathering the
+ * accounting data of every task again for each of them.
+ */
+#define STEP_STAT_CACHE_TIME 1
+typedef struct {
+	slurm_step_id_t step_id;
+	job_step_stat_t *stat;
+	time_t time;
+	uid_t uid;
+} step_stat_cache_t;
+static pthread_mutex_t step_stat_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static List step_stat_cache_list = NULL;
+
 void
 slurmd_req(slurm_msg_t *msg)
 {
@@ -288,6 +304,9 @@ slurmd_req(slurm_msg_t *msg)
 			job_limits_loaded = false;
 		}
 		slurm_mutex_unlock(&job_limits_mutex);
+		slurm_mutex_lock(&step_stat_cache_mutex);
+		FREE_NULL_LIST(step_stat_cache_list);
+		slurm_mutex_unlock(&step_stat_cache_mutex);
 		return;
 	}
 
@@ -3637,12 +3656,118 @@ static void _rpc_daemon_status(slurm_msg_t *msg)
 	slurm_free_slurmd_status(resp);
 }
 
+static void _free_step_stat_cache(void *x)
+{
+	step_stat_cache_t *cache = x;
+
+	slurm_free_job_step_stat(cache->stat);
+	xfree(cache);
+}
+
+static int _step_stat_cache_expired(void *x, void *key)
+{
+	step_stat_cache_t *cache = x;
+	time_t *now = key;
+
+	return ((*now - cache->time) > STEP_STAT_CACHE_TIME);
+}
+
+static int _step_stat_cache_match(void *x, void *key)
+{
+	step_stat_cache_t *cache = x;
+	slurm_step_id_t *step_id = key;
+
+	return ((cache->step_id.job_id == step_id->job_id) &&
+		(cache->step_id.step_id == step_id->step_id) &&
+		(cache->step_id.step_het_comp == step_id->step_het_comp));
+}
+
+static job_step_stat_t *_copy_step_stat(job_step_stat_t *stat)
+{
+	job_step_stat_t *copy = xmalloc(sizeof(*copy));
+	buf_t *buffer;
+
+	copy->num_tasks = stat->num_tasks;
+	copy->return_code = stat->return_code;
+
+	if (stat->jobacct) {
+		buffer = init_buf(BUF_SIZE);
+		jobacctinfo_pack(stat->jobacct, SLURM_PROTOCOL_VERSION,
+				 PROTOCOL_TYPE_SLURM, buffer);
+		set_buf_offset(buffer, 0);
+		(void) jobacctinfo_unpack(&copy->jobacct,
+					  SLURM_PROTOCOL_VERSION,
+					  PROTOCOL_TYPE_SLURM, buffer, true);
+		FREE_NULL_BUFFER(buffer);
+	}
+
+	if (stat->step_pids) {
+		copy->step_pids = xmalloc(sizeof(job_step_pids_t));
+		copy->step_pids->node_name =
+			xstrdup(stat->step_pids->node_name);
+		copy->step_pids->pid_cnt = stat->step_pids->pid_cnt;
+		if (stat->step_pids->pid_cnt) {
+			copy->step_pids->pid =
+				xcalloc(stat->step_pids->pid_cnt,
+					sizeof(uint32_t));
+			memcpy(copy->step_pids->pid, stat->step_pids->pid,
+			       stat->step_pids->pid_cnt * sizeof(uint32_t));
+		}
+	}
+
+	return copy;
+}
+
+/* Return a copy of a recent stat reply for the step, NULL if none */
+static job_step_stat_t *_step_stat_cache_get(slurm_step_id_t *step_id,
+					     uid_t *uid)
+{
+	step_stat_cache_t *cache;
+	job_step_stat_t *stat = NULL;
+	time_t now = time(NULL);
+
+	slurm_mutex_lock(&step_stat_cache_mutex);
+	if (step_stat_cache_list) {
+		list_delete_all(step_stat_cache_list, _step_stat_cache_expired,
+				&now);
+		if ((cache = list_find_first(step_stat_cache_list,
+					     _step_stat_cache_match,
+					     step_id))) {
+			*uid = cache->uid;
+			stat = _copy_step_stat(cache->stat);
+		}
+	}
+	slurm_mutex_unlock(&step_stat_cache_mutex);
+
+	return stat;
+}
+
+static void _step_stat_cache_add(slurm_step_id_t *step_id, uid_t uid,
+				 job_step_stat_t *stat)
+{
+	step_stat_cache_t *cache = xmalloc(sizeof(*cache));
+
+	memcpy(&cache->step_id, step_id, sizeof(cache->step_id));
+	cache->stat = _copy_step_stat(stat);
+	cache->time = time(NULL);
+	cache->uid = uid;
+
+	slurm_mutex_lock(&step_stat_cache_mutex);
+	if (!step_stat_cache_list)
+		step_stat_cache_list = list_create(_free_step_stat_cache);
+	else
+		list_delete_all(step_stat_cache_list, _step_stat_cache_match,
+				step_id);
+	list_append(step_stat_cache_list, cache);
+	slurm_mutex_unlock(&step_stat_cache_mutex);
+}
+
 static void _rpc_stat_jobacct(slurm_msg_t *msg)
 {
 	slurm_step_id_t *req = (slurm_step_id_t *)msg->data;
 	slurm_msg_t        resp_msg;
 	job_step_stat_t *resp = NULL;
-	int fd;
+	int fd = -1;
 	uint16_t protocol_version;
 	uid_t uid;
 
@@ -3650,20 +3775,22 @@ static void _rpc_stat_jobacct(slurm_msg_t *msg)
 	/* step completion messages are only allowed from other slurmstepd,
 	   so only root or SlurmUser is allowed here */
 
-	fd = stepd_connect(conf->spooldir, conf->node_name,
-			   req, &protocol_version);
-	if (fd == -1) {
-		error("stepd_connect to %ps failed: %m", req);
-		slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_ID);
-		return;
-	}
-
-	if ((uid = stepd_get_uid(fd, protocol_version)) == INFINITE) {
-		debug("stat_jobacct couldn't read from %ps: %m", req);
-		close(fd);
-		if (msg->conn_fd >= 0)
+	if (!(resp = _step_stat_cache_get(req, &uid))) {
+		fd = stepd_connect(conf->spooldir, conf->node_name,
+				   req, &protocol_version);
+		if (fd == -1) {
+			error("stepd_connect to %ps failed: %m", req);
 			slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_ID);
-		return;
+			return;
+		}
+
+		if ((uid = stepd_get_uid(fd, protocol_version)) == INFINITE) {
+			debug("stat_jobacct couldn't read from %ps: %m", req);
+			close(fd);
+			if (msg->conn_fd >= 0)
+				slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_ID);
+			return;
+		}
 	}
 
 	/*
@@ -3677,32 +3804,39 @@ static void _rpc_stat_jobacct(slurm_msg_t *msg)
 		if (msg->conn_fd >= 0) {
 			slurm_send_rc_msg(msg, ESLURM_USER_ID_MISSING);
 			/* or bad in this case */
-			close(fd);
+			if (fd >= 0)
+				close(fd);
+			slurm_free_job_step_stat(resp);
 			return;
 		}
 	}
 
-	resp = xmalloc(sizeof(job_step_stat_t));
-	resp->step_pids = xmalloc(sizeof(job_step_pids_t));
-	resp->step_pids->node_name = xstrdup(conf->node_name);
-	slurm_msg_t_copy(&resp_msg, msg);
-	resp->return_code = SLURM_SUCCESS;
+	if (fd >= 0) {
+		resp = xmalloc(sizeof(job_step_stat_t));
+		resp->step_pids = xmalloc(sizeof(job_step_pids_t));
+		resp->step_pids->node_name = xstrdup(conf->node_name);
+		resp->return_code = SLURM_SUCCESS;
 
-	if (stepd_stat_jobacct(fd, protocol_version, req, resp)
-	    == SLURM_ERROR) {
-		debug("accounting for nonexistent %ps requested", req);
-	}
+		if (stepd_stat_jobacct(fd, protocol_version, req, resp)
+		    == SLURM_ERROR) {
+			debug("accounting for nonexistent %ps requested", req);
+		}
 
-	/* FIX ME: This should probably happen in the
-	   stepd_stat_jobacct to get more information about the pids.
-	*/
-	if (stepd_list_pids(fd, protocol_version, &resp->step_pids->pid,
-			    &resp->step_pids->pid_cnt) == SLURM_ERROR) {
-		debug("No pids for nonexistent %ps requested", req);
-	}
+		/* FIX ME: This should probably happen in the
+		   stepd_stat_jobacct to get more information about the pids.
+		*/
+		if (stepd_list_pids(fd, protocol_version,
+				    &resp->step_pids->pid,
+				    &resp->step_pids->pid_cnt) == SLURM_ERROR) {
+			debug("No pids for nonexistent %ps requested", req);
+		}
 
-	close(fd);
+		close(fd);
+
+		_step_stat_cache_add(req, uid, resp);
+	}
 
+	slurm_msg_t_copy(&resp_msg, msg);
 	resp_msg.msg_type     = RESPONSE_JOB_STEP_STAT;
 	resp_msg.data         = resp;
 
@@ -8,6 +8,8 @@
 #include <stdlib.h>
 #include <src/common/bitstring.h>
 #include <src/common/job_resources.h>
+#include <src/common/pack.h>
+#include <src/common/slurm_protocol_common.h>
 #include <sys/time.h>
 #include <testsuite/dejagnu.h>
 
@@ -48,6 +50,76 @@ static job_resources_t *_alloc_job_res(void)
 	return job;
 }
 
+/* Pack and unpack a job_resources_t, return the buffer size used */
+static uint32_t _pack_unpack(job_resources_t *job, job_resources_t **job_out,
+			     uint16_t protocol_version)
+{
+	buf_t *buffer = init_buf(1024);
+	uint32_t size;
+
+	*job_out = NULL;
+	pack_job_resources(job, buffer, protocol_version);
+	size = get_buf_offset(buffer);
+	set_buf_offset(buffer, 0);
+	if (unpack_job_resources(job_out, buffer, protocol_version))
+		size = 0;
+	free_buf(buffer);
+
+	return size;
+}
+
+/* Allocation of the same cores and memory on each of node_cnt nodes */
+static job_resources_t *_alloc_uniform_job_res(uint32_t node_cnt)
+{
+	job_resources_t *job = create_job_resources();
+	uint32_t n;
+
+	job->nhosts = node_cnt;
+	job->ncpus = node_cnt * 4;
+	job->cpus = xcalloc(node_cnt, sizeof(uint16_t));
+	job->cpus_used = xcalloc(node_cnt, sizeof(uint16_t));
+	job->memory_allocated = xcalloc(node_cnt, sizeof(uint64_t));
+	job->memory_used = xcalloc(node_cnt, sizeof(uint64_t));
+	job->cores_per_socket = xcalloc(1, sizeof(uint16_t));
+	job->sockets_per_node = xcalloc(1, sizeof(uint16_t));
+	job->sock_core_rep_count = xcalloc(1, sizeof(uint32_t));
+	job->cores_per_socket[0] = 4;
+	job->sockets_per_node[0] = 2;
+	job->sock_core_rep_count[0] = node_cnt;
+	job->core_bitmap = bit_alloc(node_cnt * 8);
+	job->core_bitmap_used = bit_alloc(node_cnt * 8);
+	for (n = 0; n < node_cnt; n++) {
+		job->cpus[n] = 4;
+		job->memory_allocated[n] = 1024;
+		bit_set(job->core_bitmap, (n * 8) + 1);
+		bit_set(job->core_bitmap, (n * 8) + 2);
+		bit_set(job->core_bitmap, (n * 8) + 5);
+		bit_set(job->core_bitmap, (n * 8) + 6);
+	}
+
+	return job;
+}
+
+static bool _job_res_equal(job_resources_t *job1, job_resources_t *job2)
+{
+	uint32_t n;
+
+	if (!job1 || !job2 || (job1->nhosts != job2->nhosts) ||
+	    (job1->ncpus != job2->ncpus) ||
+	    !bit_equal(job1->core_bitmap, job2->core_bitmap) ||
+	    !bit_equal(job1->core_bitmap_used, job2->core_bitmap_used))
+		return false;
+	for (n = 0; n < job1->nhosts; n++) {
+		if ((job1->cpus[n] != job2->cpus[n]) ||
+		    (job1->cpus_used[n] != job2->cpus_used[n]) ||
+		    (job1->memory_allocated[n] !=
+		     job2->memory_allocated[n]) ||
+		    (job1->memory_used[n] != job2->memory_used[n]))
+			return false;
+	}
+	return true;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -157,6 +229,29 @@ main(int argc, char *argv[])
 	_free_job_res(job1);
 	_free_job_res(job2);
 
+	note("Testing pack_job_resources/unpack_job_resources");
+	job1 = _alloc_uniform_job_res(1000);
+	TEST(_pack_unpack(job1, &job2, SLURM_23_02_PROTOCOL_VERSION) < 512,
+	     "uniform allocation packs compactly");
+	TEST(_job_res_equal(job1, job2), "uniform allocation unpacked");
+	free_job_resources(&job2);
+	TEST(_pack_unpack(job1, &job2, SLURM_22_05_PROTOCOL_VERSION) > 8000,
+	     "uniform allocation packs in full for older protocol");
+	TEST(_job_res_equal(job1, job2),
+	     "uniform allocation unpacked for older protocol");
+	free_job_resources(&job2);
+
+	job1->cpus[10] = 2;
+	job1->memory_used[999] = 512;
+	bit_clear(job1->core_bitmap, 10 * 8 + 1);
+	bit_clear(job1->core_bitmap, 10 * 8 + 2);
+	bit_set(job1->core_bitmap_used, 999 * 8 + 6);
+	TEST(_pack_unpack(job1, &job2, SLURM_23_02_PROTOCOL_VERSION),
+	     "non-uniform allocation packed");
+	TEST(_job_res_equal(job1, job2), "non-uniform allocation unpacked");
+	free_job_resources(&job2);
+	free_job_resources(&job1);
+
 	totals();
 	return failed;
 }